@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/sink.h"
@@ -17,6 +19,7 @@ DspInterface::~DspInterface() = default;
 void DspInterface::SetSink(const std::string& sink_id, const std::string& audio_device) {
     const SinkDetails& sink_details = GetSinkDetails(sink_id);
     sink = sink_details.factory(audio_device);
+    output_discarded = sink->DiscardsOutput();
     sink->SetCallback(
         [this](s16* buffer, std::size_t num_frames) { OutputCallback(buffer, num_frames); });
     time_stretcher.SetOutputSampleRate(sink->GetNativeSampleRate());
@@ -37,27 +40,83 @@ void DspInterface::EnableStretching(bool enable) {
     perform_time_stretching = enable;
 }
 
+bool DspInterface::IsPacingEmulation() const {
+    return Settings::values.enable_audio_pacing && Settings::values.use_frame_limit &&
+           Settings::values.frame_limit == 100 && sink_active;
+}
+
+DspInterface::OutputStats DspInterface::GetAndResetOutputStats() {
+    OutputStats stats{};
+    const u32 count = callback_count.exchange(0);
+    const u64 length_sum = queue_length_sum.exchange(0);
+    if (count != 0 && sink) {
+        stats.queue_length = static_cast<double>(length_sum) / count / sink->GetNativeSampleRate();
+    }
+    stats.underruns = underruns.exchange(0);
+    stats.stretch_ratio = stretch_ratio;
+    return stats;
+}
+
 void DspInterface::OutputFrame(StereoFrame16& frame) {
     if (!sink)
         return;
 
+    if (sink->PushSamples(frame[0].data(), frame.size()))
+        return;
+
+    if (IsPacingEmulation()) {
+        // Throttle emulation until the sink has consumed the audio queued above the latency target
+        constexpr u16 min_latency = 10;
+        constexpr u16 max_latency = 250;
+        const u16 latency = std::clamp(Settings::values.audio_latency, min_latency, max_latency);
+        const std::size_t target = std::min<std::size_t>(
+            latency * sink->GetNativeSampleRate() / 1000, fifo.Capacity() - frame.size());
+        while (fifo.Size() + frame.size() > target) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+            if (!samples_consumed.WaitUntil(deadline)) {
+                // The sink stopped requesting samples, let the frame limiter take over
+                sink_active = false;
+                break;
+            }
+        }
+    }
+
     fifo.Push(frame.data(), frame.size());
 }
 
 void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
+    sink_active = true;
+    queue_length_sum += fifo.Size();
+    ++callback_count;
+
+    // Pacing keeps the amount of queued audio constant, which makes stretching unnecessary
+    const bool stretch = perform_time_stretching && !IsPacingEmulation();
+
     std::size_t frames_written;
-    if (perform_time_stretching) {
+    if (stretch) {
         const std::vector<s16> in{fifo.Pop()};
         const std::size_t num_in{in.size() / 2};
         frames_written = time_stretcher.Process(in.data(), num_in, buffer, num_frames);
-    } else if (flushing_time_stretcher) {
+        stretch_ratio = time_stretcher.GetStretchRatio();
+        was_stretching = true;
+    } else if (flushing_time_stretcher || was_stretching) {
         time_stretcher.Flush();
         frames_written = time_stretcher.Process(nullptr, 0, buffer, num_frames);
         frames_written += fifo.Pop(buffer, num_frames - frames_written);
         flushing_time_stretcher = false;
+        was_stretching = false;
+        stretch_ratio = 1.0;
     } else {
         frames_written = fifo.Pop(buffer, num_frames);
     }
+    samples_consumed.Set();
+
+    // Count every time the output runs dry, rather than every callback while it is dry
+    const bool is_underrun = frames_written < num_frames;
+    if (is_underrun && !was_underrun) {
+        ++underruns;
+    }
+    was_underrun = is_underrun;
 
     if (frames_written > 0) {
         std::memcpy(&last_frame[0], buffer + 2 * (frames_written - 1), 2 * sizeof(s16));
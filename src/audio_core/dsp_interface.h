@@ -4,12 +4,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include "audio_core/audio_types.h"
 #include "audio_core/time_stretch.h"
 #include "common/common_types.h"
 #include "common/ring_buffer.h"
+#include "common/thread.h"
 #include "core/memory.h"
 
 namespace Service {
@@ -24,6 +26,16 @@ class Sink;
 
 class DspInterface {
 public:
+    /// Statistics of the audio output since they were last reset
+    struct OutputStats {
+        /// Average amount of audio queued for the sink when it requested samples, in seconds
+        double queue_length;
+        /// Number of times the sink ran out of samples
+        u32 underruns;
+        /// Tempo ratio last applied by the time stretcher, 1.0 when not stretching
+        double stretch_ratio;
+    };
+
     DspInterface();
     virtual ~DspInterface();
 
@@ -74,9 +86,23 @@ public:
     void SetSink(const std::string& sink_id, const std::string& audio_device);
     /// Get the current sink
     Sink& GetSink();
+    /// Returns whether the sink discards the audio output, so that it does not need to be generated
+    bool IsOutputDiscarded() const {
+        return output_discarded;
+    }
     /// Enable/Disable audio stretching.
     void EnableStretching(bool enable);
 
+    /**
+     * Returns whether emulation is paced by the audio output instead of the frame limiter. This is
+     * the case when audio pacing and a frame limit of 100% are set, and the sink is requesting
+     * samples.
+     */
+    bool IsPacingEmulation() const;
+
+    /// Gets the statistics of the audio output and resets them
+    OutputStats GetAndResetOutputStats();
+
 protected:
     void OutputFrame(StereoFrame16& frame);
 
@@ -85,11 +111,27 @@ private:
     void OutputCallback(s16* buffer, std::size_t num_frames);
 
     std::unique_ptr<Sink> sink;
+    bool output_discarded = false;
     std::atomic<bool> perform_time_stretching = false;
     std::atomic<bool> flushing_time_stretcher = false;
     Common::RingBuffer<s16, 0x2000, 2> fifo;
     std::array<s16, 2> last_frame{};
-    TimeStretcher time_stretcher;
+    TimeStretcher time_stretcher{Settings::values.time_stretch_algorithm};
+
+    /// Whether the sink is requesting samples
+    std::atomic<bool> sink_active{false};
+    /// Signaled by the sink every time it takes samples out of the fifo
+    Common::Event samples_consumed;
+
+    // Only accessed by the sink callback
+    bool was_stretching = false;
+    bool was_underrun = false;
+
+    // Output statistics, written by the sink callback
+    std::atomic<u64> queue_length_sum{0};
+    std::atomic<u32> callback_count{0};
+    std::atomic<u32> underruns{0};
+    std::atomic<double> stretch_ratio{1.0};
 };
 
 } // namespace AudioCore
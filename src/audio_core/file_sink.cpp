@@ -0,0 +1,167 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <limits>
+#include <thread>
+#include <fmt/format.h>
+#include "audio_core/audio_types.h"
+#include "audio_core/file_sink.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "common/threadsafe_queue.h"
+
+namespace AudioCore {
+
+namespace {
+
+struct WavHeader {
+    std::array<char, 4> riff_id;
+    u32_le riff_size;
+    std::array<char, 4> wave_id;
+    std::array<char, 4> fmt_id;
+    u32_le fmt_size;
+    u16_le format;
+    u16_le num_channels;
+    u32_le sample_rate;
+    u32_le byte_rate;
+    u16_le block_align;
+    u16_le bits_per_sample;
+    std::array<char, 4> data_id;
+    u32_le data_size;
+};
+static_assert(sizeof(WavHeader) == 44, "WavHeader has incorrect size");
+
+/// Largest amount of whole stereo frames the 32-bit sizes of a WAV file can describe (about 9h)
+constexpr u64 max_wav_data_size =
+    (std::numeric_limits<u32>::max() - (sizeof(WavHeader) - 8)) / 4 * 4;
+
+WavHeader MakeWavHeader(u32 data_size) {
+    constexpr u16 num_channels = 2;
+    constexpr u16 bits_per_sample = 16;
+    constexpr u16 block_align = num_channels * bits_per_sample / 8;
+
+    WavHeader header;
+    header.riff_id = {'R', 'I', 'F', 'F'};
+    header.riff_size = static_cast<u32>(sizeof(WavHeader) - 8 + data_size);
+    header.wave_id = {'W', 'A', 'V', 'E'};
+    header.fmt_id = {'f', 'm', 't', ' '};
+    header.fmt_size = 16;
+    header.format = 1; // PCM
+    header.num_channels = num_channels;
+    header.sample_rate = native_sample_rate;
+    header.byte_rate = native_sample_rate * block_align;
+    header.block_align = block_align;
+    header.bits_per_sample = bits_per_sample;
+    header.data_id = {'d', 'a', 't', 'a'};
+    header.data_size = data_size;
+    return header;
+}
+
+} // anonymous namespace
+
+struct FileSink::Impl {
+    FileUtil::IOFile file;
+    FileUtil::IOFile hash_file;
+    bool is_wav = false;
+    bool size_limit_reached = false;
+    u64 data_size = 0;
+    u64 frames_written = 0;
+
+    /// Blocks of samples to write, an empty block stops the writer thread
+    Common::SPSCQueue<std::vector<s16>> queue;
+    /// Written blocks handed back to PushSamples, so that their storage is reused
+    Common::SPSCQueue<std::vector<s16>> free_blocks;
+    std::thread writer_thread;
+
+    void WriteBlock(const std::vector<s16>& block) {
+        const std::size_t size = block.size() * sizeof(s16);
+        if (is_wav && data_size + size > max_wav_data_size) {
+            if (!size_limit_reached) {
+                LOG_WARNING(Audio_Sink, "WAV file size limit reached, stopped recording audio");
+                size_limit_reached = true;
+            }
+            return;
+        }
+
+        file.WriteBytes(block.data(), size);
+        hash_file.WriteString(fmt::format("{:016X}\n", Common::ComputeHash64(block.data(), size)));
+        data_size += size;
+        ++frames_written;
+    }
+};
+
+FileSink::FileSink(std::string device_name) : impl(std::make_unique<Impl>()) {
+    std::string path;
+    if (device_name == auto_device_name || device_name == "wav" || device_name == "raw") {
+        const std::string extension = device_name == "raw" ? "raw" : "wav";
+        path = fmt::format("{}audio_dump.{}", FileUtil::GetUserPath(FileUtil::UserPath::UserDir),
+                           extension);
+    } else {
+        path = std::move(device_name);
+    }
+    impl->is_wav = path.size() >= 4 && path.compare(path.size() - 4, 4, ".wav") == 0;
+
+    if (!impl->file.Open(path, "wb") || !impl->hash_file.Open(path + ".hashes", "w")) {
+        LOG_CRITICAL(Audio_Sink, "Failed to open audio dump file {}", path);
+        impl->file.Close();
+        return;
+    }
+
+    if (impl->is_wav) {
+        // The sizes are filled in once recording has finished
+        impl->file.WriteObject(MakeWavHeader(0));
+    }
+
+    LOG_INFO(Audio_Sink, "Recording audio to {}", path);
+
+    impl->writer_thread = std::thread([this] {
+        while (true) {
+            std::vector<s16> block = impl->queue.PopWait();
+            if (block.empty())
+                break;
+            impl->WriteBlock(block);
+            impl->free_blocks.Push(std::move(block));
+        }
+    });
+}
+
+FileSink::~FileSink() {
+    if (!impl->writer_thread.joinable())
+        return;
+
+    impl->queue.Push(std::vector<s16>{});
+    impl->writer_thread.join();
+
+    if (impl->is_wav && impl->file.Seek(0, SEEK_SET)) {
+        impl->file.WriteObject(MakeWavHeader(static_cast<u32>(impl->data_size)));
+    }
+
+    LOG_INFO(Audio_Sink, "Recorded {} audio frames ({} bytes)", impl->frames_written,
+             impl->data_size);
+}
+
+unsigned int FileSink::GetNativeSampleRate() const {
+    return native_sample_rate;
+}
+
+void FileSink::SetCallback(std::function<void(s16*, std::size_t)>) {}
+
+bool FileSink::PushSamples(const s16* samples, std::size_t sample_count) {
+    if (impl->writer_thread.joinable() && sample_count != 0) {
+        std::vector<s16> block;
+        impl->free_blocks.Pop(block);
+        block.assign(samples, samples + sample_count * 2);
+        impl->queue.Push(std::move(block));
+    }
+    return true;
+}
+
+std::vector<std::string> ListFileSinkDevices() {
+    return {"wav", "raw"};
+}
+
+} // namespace AudioCore
@@ -0,0 +1,42 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "audio_core/sink.h"
+
+namespace AudioCore {
+
+/**
+ * Records the output of the emulated DSP to a file instead of playing it. Every frame produced by
+ * the DSP is written as it is, without going through the time stretcher or an audio device, so the
+ * recording is deterministic. The frames are written by a separate thread.
+ *
+ * The device name selects the output: "wav" or "raw" write to a file of that type in the user
+ * directory, any other name is used as the path of the file, which is a WAV file if it has a .wav
+ * extension and raw interleaved stereo PCM16 otherwise. The 64-bit hash of each frame is written
+ * to a text file next to it, one per line.
+ */
+class FileSink final : public Sink {
+public:
+    explicit FileSink(std::string device_name);
+    ~FileSink() override;
+
+    unsigned int GetNativeSampleRate() const override;
+
+    void SetCallback(std::function<void(s16*, std::size_t)> cb) override;
+
+    bool PushSamples(const s16* samples, std::size_t sample_count) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+std::vector<std::string> ListFileSinkDevices();
+
+} // namespace AudioCore
@@ -0,0 +1,84 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "audio_core/hle/decoded_buffer_cache.h"
+
+namespace AudioCore {
+namespace HLE {
+
+namespace {
+
+/// Returns the number of bytes of ADPCM data that are read to decode sample_count samples
+std::size_t GetADPCMDataSize(std::size_t sample_count) {
+    // Frames are 8 bytes long, consisting of a header byte and 14 samples of 4 bits each
+    constexpr std::size_t FRAME_LEN = 8;
+    constexpr std::size_t SAMPLES_PER_FRAME = 14;
+
+    const std::size_t remaining_samples = sample_count % SAMPLES_PER_FRAME;
+    std::size_t size = sample_count / SAMPLES_PER_FRAME * FRAME_LEN;
+    if (remaining_samples != 0) {
+        size += 1 + (remaining_samples + 1) / 2;
+    }
+    return size;
+}
+
+} // anonymous namespace
+
+void DecodedBufferCache::DecodeADPCM(PAddr physical_address, const u8* data,
+                                     std::size_t sample_count,
+                                     const std::array<s16, 16>& adpcm_coeff,
+                                     Codec::ADPCMState& state, StereoBuffer16& output) {
+    DecodedBufferKey key;
+    key.state.data_hash = Common::ComputeHash64(data, GetADPCMDataSize(sample_count));
+    key.state.physical_address = physical_address;
+    key.state.sample_count = static_cast<u32>(sample_count);
+    key.state.adpcm_coeffs = adpcm_coeff;
+    key.state.yn1 = state.yn1;
+    key.state.yn2 = state.yn2;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = entry_map.find(key);
+        if (it != entry_map.end()) {
+            entries.splice(entries.begin(), entries, it->second);
+            const Entry& entry = *it->second;
+            output.insert(output.end(), entry.samples.begin(), entry.samples.end());
+            state = entry.end_state;
+            return;
+        }
+    }
+
+    // Decode without holding the lock so that other sources are not held up
+    const std::size_t output_start = output.size();
+    Codec::DecodeADPCM(data, sample_count, adpcm_coeff, state, output);
+    const auto decoded_begin = output.begin() + output_start;
+    const std::size_t num_frames = output.size() - output_start;
+    if (num_frames > MAX_CACHED_FRAMES)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entry_map.count(key) != 0)
+        return;
+
+    entries.push_front({key, StereoBuffer16(decoded_begin, output.end()), state});
+    entry_map.emplace(key, entries.begin());
+    cached_frames += num_frames;
+
+    while (cached_frames > MAX_CACHED_FRAMES) {
+        const Entry& oldest = entries.back();
+        cached_frames -= oldest.samples.size();
+        entry_map.erase(oldest.key);
+        entries.pop_back();
+    }
+}
+
+void DecodedBufferCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    entry_map.clear();
+    cached_frames = 0;
+}
+
+} // namespace HLE
+} // namespace AudioCore
@@ -0,0 +1,91 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include "audio_core/audio_types.h"
+#include "audio_core/codec.h"
+#include "common/common_types.h"
+#include "common/hash.h"
+
+namespace AudioCore {
+namespace HLE {
+
+struct DecodedBufferKeyRaw {
+    u64 data_hash;
+    PAddr physical_address;
+    u32 sample_count;
+    std::array<s16, 16> adpcm_coeffs;
+    s16 yn1;
+    s16 yn2;
+};
+
+/// Identifies a decoded ADPCM buffer. It depends on the decoder state as well as on the data.
+struct DecodedBufferKey : Common::HashableStruct<DecodedBufferKeyRaw> {};
+
+} // namespace HLE
+} // namespace AudioCore
+
+namespace std {
+template <>
+struct hash<AudioCore::HLE::DecodedBufferKey> {
+    std::size_t operator()(const AudioCore::HLE::DecodedBufferKey& k) const {
+        return k.Hash();
+    }
+};
+} // namespace std
+
+namespace AudioCore {
+namespace HLE {
+
+/**
+ * Keeps the decoded samples of recently played ADPCM buffers. Applications play the same sound
+ * effects over and over, so most buffers do not need to be decoded again. Entries are validated
+ * by a hash of the buffer data, so buffers that are rewritten by the application are decoded anew.
+ * The cache is shared by all sources and may be used from several threads at once.
+ */
+class DecodedBufferCache final {
+public:
+    /**
+     * Decodes an ADPCM buffer, or takes its samples from the cache. This behaves exactly like
+     * Codec::DecodeADPCM.
+     * @param physical_address Address of the buffer data
+     * @param data Pointer to the buffer data
+     * @param sample_count Length of buffer in terms of number of samples
+     * @param adpcm_coeff ADPCM coefficients
+     * @param state ADPCM state, this is updated with new state
+     * @param output Buffer to append the decoded samples to
+     */
+    void DecodeADPCM(PAddr physical_address, const u8* data, std::size_t sample_count,
+                     const std::array<s16, 16>& adpcm_coeff, Codec::ADPCMState& state,
+                     StereoBuffer16& output);
+
+    /// Removes all entries
+    void Clear();
+
+private:
+    struct Entry {
+        DecodedBufferKey key;
+        StereoBuffer16 samples;
+        Codec::ADPCMState end_state;
+    };
+
+    /// Upper bound on the number of cached samples, in stereo frames (4 MiB)
+    static constexpr std::size_t MAX_CACHED_FRAMES = 1024 * 1024;
+
+    std::mutex mutex;
+    /// Entries ordered from the most to the least recently used
+    std::list<Entry> entries;
+    std::unordered_map<DecodedBufferKey, std::list<Entry>::iterator> entry_map;
+    std::size_t cached_frames = 0;
+};
+
+} // namespace HLE
+} // namespace AudioCore
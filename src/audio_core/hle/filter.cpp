@@ -17,6 +17,11 @@ void SourceFilters::Reset() {
     Enable(false, false);
 }
 
+void SourceFilters::ClearHistory() {
+    simple_filter.ClearHistory();
+    biquad_filter.ClearHistory();
+}
+
 void SourceFilters::Enable(bool simple, bool biquad) {
     simple_filter_enabled = simple;
     biquad_filter_enabled = biquad;
@@ -51,12 +56,16 @@ void SourceFilters::ProcessFrame(StereoFrame16& frame) {
 // SimpleFilter
 
 void SourceFilters::SimpleFilter::Reset() {
-    y1.fill(0);
+    ClearHistory();
     // Configure as passthrough.
     a1 = 0;
     b0 = 1 << 15;
 }
 
+void SourceFilters::SimpleFilter::ClearHistory() {
+    y1.fill(0);
+}
+
 void SourceFilters::SimpleFilter::Configure(
     SourceConfiguration::Configuration::SimpleFilter config) {
 
@@ -79,13 +88,17 @@ std::array<s16, 2> SourceFilters::SimpleFilter::ProcessSample(const std::array<s
 // BiquadFilter
 
 void SourceFilters::BiquadFilter::Reset() {
+    ClearHistory();
+    // Configure as passthrough.
+    a1 = a2 = b1 = b2 = 0;
+    b0 = 1 << 14;
+}
+
+void SourceFilters::BiquadFilter::ClearHistory() {
     x1.fill(0);
     x2.fill(0);
     y1.fill(0);
     y2.fill(0);
-    // Configure as passthrough.
-    a1 = a2 = b1 = b2 = 0;
-    b0 = 1 << 14;
 }
 
 void SourceFilters::BiquadFilter::Configure(
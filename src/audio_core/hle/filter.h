@@ -22,6 +22,9 @@ public:
     /// Reset internal state.
     void Reset();
 
+    /// Clears the sample history of the filters, keeping their configuration
+    void ClearHistory();
+
     /**
      * Enable/Disable filters
      * See also: SourceConfiguration::Configuration::simple_filter_enabled,
@@ -61,6 +64,9 @@ private:
         /// Resets internal state.
         void Reset();
 
+        /// Clears the sample history
+        void ClearHistory();
+
         /**
          * Configures this filter with application settings.
          * @param config Configuration from DSP shared memory.
@@ -89,6 +95,9 @@ private:
         /// Resets internal state.
         void Reset();
 
+        /// Clears the sample history
+        void ClearHistory();
+
         /**
          * Configures this filter with application settings.
          * @param config Configuration from DSP shared memory.
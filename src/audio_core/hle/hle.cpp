@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <thread>
+#include <vector>
 #include "audio_core/audio_types.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/hle.h"
@@ -12,7 +15,9 @@
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/worker_pool.h"
 #include "core/core_timing.h"
+#include "core/settings.h"
 
 using InterruptType = Service::DSP::DSP_DSP::InterruptType;
 using Service::DSP::DSP_DSP;
@@ -21,6 +26,9 @@ namespace AudioCore {
 
 static constexpr u64 audio_frame_ticks = 1310252ull; ///< Units: ARM11 cycles
 
+/// Maximum number of worker threads processing sources in addition to the emulation thread
+static constexpr unsigned max_source_workers = 3;
+
 struct DspHle::Impl final {
 public:
     explicit Impl(DspHle& parent);
@@ -53,15 +61,22 @@ private:
     std::array<std::vector<u8>, num_dsp_pipe> pipe_data;
 
     HLE::DspMemory dsp_memory;
+    HLE::DecodedBufferCache buffer_cache;
     std::array<HLE::Source, HLE::num_sources> sources{{
-        HLE::Source(0),  HLE::Source(1),  HLE::Source(2),  HLE::Source(3),  HLE::Source(4),
-        HLE::Source(5),  HLE::Source(6),  HLE::Source(7),  HLE::Source(8),  HLE::Source(9),
-        HLE::Source(10), HLE::Source(11), HLE::Source(12), HLE::Source(13), HLE::Source(14),
-        HLE::Source(15), HLE::Source(16), HLE::Source(17), HLE::Source(18), HLE::Source(19),
-        HLE::Source(20), HLE::Source(21), HLE::Source(22), HLE::Source(23),
+        HLE::Source(0, buffer_cache),  HLE::Source(1, buffer_cache),  HLE::Source(2, buffer_cache),
+        HLE::Source(3, buffer_cache),  HLE::Source(4, buffer_cache),  HLE::Source(5, buffer_cache),
+        HLE::Source(6, buffer_cache),  HLE::Source(7, buffer_cache),  HLE::Source(8, buffer_cache),
+        HLE::Source(9, buffer_cache),  HLE::Source(10, buffer_cache), HLE::Source(11, buffer_cache),
+        HLE::Source(12, buffer_cache), HLE::Source(13, buffer_cache), HLE::Source(14, buffer_cache),
+        HLE::Source(15, buffer_cache), HLE::Source(16, buffer_cache), HLE::Source(17, buffer_cache),
+        HLE::Source(18, buffer_cache), HLE::Source(19, buffer_cache), HLE::Source(20, buffer_cache),
+        HLE::Source(21, buffer_cache), HLE::Source(22, buffer_cache), HLE::Source(23, buffer_cache),
     }};
     HLE::Mixers mixers;
 
+    /// Created on first use when DSP multithreading is enabled
+    std::unique_ptr<Common::WorkerPool> source_workers;
+
     DspHle& parent;
     CoreTiming::EventType* tick_event;
 
@@ -154,6 +169,8 @@ void DspHle::Impl::PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer)
         case StateChange::Initialize:
             LOG_INFO(Audio_DSP, "Application has requested initialization of DSP hardware");
             ResetPipes();
+            // The buffers decoded so far belong to the previous user of the DSP
+            buffer_cache.Clear();
             AudioPipeWriteStructAddresses();
             dsp_state = DspState::On;
             break;
@@ -280,12 +297,38 @@ StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
 
     std::array<QuadFrame32, 3> intermediate_mixes = {};
 
-    // Generate intermediate mixes
-    for (std::size_t i = 0; i < HLE::num_sources; i++) {
+    // Without audio output only the state visible to the application has to be kept up to date.
+    // The sources still advance through their buffers, but nothing is decoded or mixed.
+    const bool discard_output = parent.IsOutputDiscarded();
+
+    const auto tick_source = [&](std::size_t i) {
         write.source_statuses.status[i] =
-            sources[i].Tick(read.source_configurations.config[i], read.adpcm_coefficients.coeff[i]);
-        for (std::size_t mix = 0; mix < 3; mix++) {
-            sources[i].MixInto(intermediate_mixes[mix], mix);
+            sources[i].Tick(read.source_configurations.config[i], read.adpcm_coefficients.coeff[i],
+                            discard_output);
+    };
+
+    if (Settings::values.enable_dsp_multithreading) {
+        if (!source_workers) {
+            const unsigned num_workers =
+                std::clamp(std::thread::hardware_concurrency(), 2u, max_source_workers + 1) - 1;
+            source_workers = std::make_unique<Common::WorkerPool>("DspSourceWorker", num_workers);
+        }
+        // Each source only accesses its own state and its own part of the shared memory, so they
+        // can be ticked in any order. Mixing is done in order afterwards, giving the same output
+        // as the serial path.
+        source_workers->ParallelFor(HLE::num_sources, tick_source);
+    } else {
+        for (std::size_t i = 0; i < HLE::num_sources; i++) {
+            tick_source(i);
+        }
+    }
+
+    // Generate intermediate mixes
+    if (!discard_output) {
+        for (std::size_t i = 0; i < HLE::num_sources; i++) {
+            for (std::size_t mix = 0; mix < 3; mix++) {
+                sources[i].MixInto(intermediate_mixes[mix], mix);
+            }
         }
     }
 
@@ -312,7 +355,9 @@ bool DspHle::Impl::Tick() {
     // shared memory region)
     current_frame = GenerateCurrentFrame();
 
-    parent.OutputFrame(current_frame);
+    if (!parent.IsOutputDiscarded()) {
+        parent.OutputFrame(current_frame);
+    }
 
     return true;
 }
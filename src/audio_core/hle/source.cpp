@@ -4,6 +4,10 @@
 
 #include <algorithm>
 #include <array>
+#include <utility>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/codec.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/source.h"
@@ -16,7 +20,14 @@ namespace AudioCore {
 namespace HLE {
 
 SourceStatus::Status Source::Tick(SourceConfiguration::Configuration& config,
-                                  const s16_le (&adpcm_coeffs)[16]) {
+                                  const s16_le (&adpcm_coeffs)[16], bool discard_output_) {
+    if (discard_output && !discard_output_) {
+        // The discarded frames were silent, but the ADPCM predictor and the filters were not run
+        // on them. Restart their history from silence to match.
+        state.adpcm_state = {};
+        state.filters.ClearHistory();
+    }
+    discard_output = discard_output_;
     ParseConfig(config, adpcm_coeffs);
 
     if (state.enabled) {
@@ -31,6 +42,23 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
         return;
 
     const std::array<float, 4>& gains = state.gain.at(intermediate_mix_id);
+#ifdef ARCHITECTURE_x86_64
+    // Two samples at a time, producing the same results as the scalar code below
+    const __m128 gain = _mm_loadu_ps(gains.data());
+    const auto mix_sample = [&gain](std::array<s32, 4>& out, __m128i sample) {
+        __m128i* const out_ptr = reinterpret_cast<__m128i*>(out.data());
+        const __m128i mixed = _mm_cvttps_epi32(_mm_mul_ps(gain, _mm_cvtepi32_ps(sample)));
+        _mm_storeu_si128(out_ptr, _mm_add_epi32(_mm_loadu_si128(out_ptr), mixed));
+    };
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+        // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
+        const __m128i stereo =
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(current_frame[samplei].data()));
+        const __m128i stereo32 = _mm_srai_epi32(_mm_unpacklo_epi16(stereo, stereo), 16);
+        mix_sample(dest[samplei], _mm_shuffle_epi32(stereo32, _MM_SHUFFLE(1, 0, 1, 0)));
+        mix_sample(dest[samplei + 1], _mm_shuffle_epi32(stereo32, _MM_SHUFFLE(3, 2, 3, 2)));
+    }
+#else
     for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
         // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
         dest[samplei][0] += static_cast<s32>(gains[0] * current_frame[samplei][0]);
@@ -38,11 +66,17 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
         dest[samplei][2] += static_cast<s32>(gains[2] * current_frame[samplei][0]);
         dest[samplei][3] += static_cast<s32>(gains[3] * current_frame[samplei][1]);
     }
+#endif
 }
 
 void Source::Reset() {
     current_frame.fill({});
+
+    // Keep the storage of the sample buffer, sources are reset whenever a new sound starts playing
+    StereoBuffer16 buffer = std::move(state.current_buffer);
+    buffer.clear();
     state = {};
+    state.current_buffer = std::move(buffer);
 }
 
 void Source::ParseConfig(SourceConfiguration::Configuration& config,
@@ -229,7 +263,7 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
 void Source::GenerateFrame() {
     current_frame.fill({});
 
-    if (state.current_buffer.empty() && !DequeueBuffer()) {
+    if (IsCurrentBufferEmpty() && !DequeueBuffer()) {
         state.enabled = false;
         state.buffer_update = true;
         state.current_buffer_id = 0;
@@ -240,23 +274,26 @@ void Source::GenerateFrame() {
 
     state.current_sample_number = state.next_sample_number;
     while (frame_position < current_frame.size()) {
-        if (state.current_buffer.empty() && !DequeueBuffer()) {
+        if (IsCurrentBufferEmpty() && !DequeueBuffer()) {
             break;
         }
 
         switch (state.interpolation_mode) {
         case InterpolationMode::None:
-            AudioInterp::None(state.interp_state, state.current_buffer, state.rate_multiplier,
-                              current_frame, frame_position);
+            AudioInterp::None(state.interp_state, state.current_buffer,
+                              state.current_buffer_position, state.rate_multiplier, current_frame,
+                              frame_position);
             break;
         case InterpolationMode::Linear:
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
+            AudioInterp::Linear(state.interp_state, state.current_buffer,
+                                state.current_buffer_position, state.rate_multiplier,
                                 current_frame, frame_position);
             break;
         case InterpolationMode::Polyphase:
             // TODO(merry): Implement polyphase interpolation
             LOG_DEBUG(Audio_DSP, "Polyphase interpolation unimplemented; falling back to linear");
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
+            AudioInterp::Linear(state.interp_state, state.current_buffer,
+                                state.current_buffer_position, state.rate_multiplier,
                                 current_frame, frame_position);
             break;
         default:
@@ -266,11 +303,17 @@ void Source::GenerateFrame() {
     }
     state.next_sample_number += static_cast<u32>(frame_position);
 
-    state.filters.ProcessFrame(current_frame);
+    if (!discard_output) {
+        state.filters.ProcessFrame(current_frame);
+    }
+}
+
+bool Source::IsCurrentBufferEmpty() const {
+    return state.current_buffer_position + 2 >= state.current_buffer.size();
 }
 
 bool Source::DequeueBuffer() {
-    ASSERT_MSG(state.current_buffer.empty(),
+    ASSERT_MSG(IsCurrentBufferEmpty(),
                "Shouldn't dequeue; we still have data in current_buffer");
 
     if (state.input_queue.empty())
@@ -284,20 +327,30 @@ bool Source::DequeueBuffer() {
         state.adpcm_state.yn2 = buf.adpcm_yn[1];
     }
 
+    // The new samples continue from the historical samples of the previous buffer
+    state.current_buffer.assign({state.interp_state.xn2, state.interp_state.xn1});
+    state.current_buffer_position = 0;
+
     const u8* const memory = Memory::GetPhysicalPointer(buf.physical_address);
-    if (memory) {
+    if (memory && discard_output) {
+        // Only the number of samples matters for the buffer position, which is visible to the
+        // application. Like the decoder, an ADPCM buffer is padded to an even number of samples.
+        const std::size_t num_samples =
+            buf.format == Format::ADPCM ? buf.length + buf.length % 2 : buf.length;
+        state.current_buffer.resize(state.current_buffer.size() + num_samples);
+    } else if (memory) {
         const unsigned num_channels = buf.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
         switch (buf.format) {
         case Format::PCM8:
-            state.current_buffer = Codec::DecodePCM8(num_channels, memory, buf.length);
+            Codec::DecodePCM8(num_channels, memory, buf.length, state.current_buffer);
             break;
         case Format::PCM16:
-            state.current_buffer = Codec::DecodePCM16(num_channels, memory, buf.length);
+            Codec::DecodePCM16(num_channels, memory, buf.length, state.current_buffer);
             break;
         case Format::ADPCM:
             DEBUG_ASSERT(num_channels == 1);
-            state.current_buffer =
-                Codec::DecodeADPCM(memory, buf.length, state.adpcm_coeffs, state.adpcm_state);
+            buffer_cache.DecodeADPCM(buf.physical_address, memory, buf.length, state.adpcm_coeffs,
+                                     state.adpcm_state, state.current_buffer);
             break;
         default:
             UNIMPLEMENTED();
@@ -307,7 +360,6 @@ bool Source::DequeueBuffer() {
         LOG_WARNING(Audio_DSP,
                     "source_id={} buffer_id={} length={}: Invalid physical address {:#010x}",
                     source_id, buf.buffer_id, buf.length, buf.physical_address);
-        state.current_buffer.clear();
         return true;
     }
 
@@ -323,7 +375,7 @@ bool Source::DequeueBuffer() {
     }
 
     LOG_TRACE(Audio_DSP, "source_id={} buffer_id={} from_queue={} current_buffer.size()={}",
-              source_id, buf.buffer_id, buf.from_queue, state.current_buffer.size());
+              source_id, buf.buffer_id, buf.from_queue, state.current_buffer.size() - 2);
     return true;
 }
 
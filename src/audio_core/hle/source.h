@@ -10,6 +10,7 @@
 #include "audio_core/audio_types.h"
 #include "audio_core/codec.h"
 #include "audio_core/hle/common.h"
+#include "audio_core/hle/decoded_buffer_cache.h"
 #include "audio_core/hle/filter.h"
 #include "audio_core/interpolate.h"
 #include "common/common_types.h"
@@ -28,7 +29,8 @@ namespace HLE {
  */
 class Source final {
 public:
-    explicit Source(std::size_t source_id_) : source_id(source_id_) {
+    Source(std::size_t source_id_, DecodedBufferCache& buffer_cache_)
+        : source_id(source_id_), buffer_cache(buffer_cache_) {
         Reset();
     }
 
@@ -40,11 +42,13 @@ public:
      * @param config The new configuration we've got for this Source from the application.
      * @param adpcm_coeffs ADPCM coefficients to use if config tells us to use them (may contain
      * invalid values otherwise).
+     * @param discard_output If true, the audio output is not needed. Buffers are not decoded and
+     * the output is silent, but the buffer positions advance as usual.
      * @return The current status of this Source. This is given back to the emulated application via
      * SharedMemory.
      */
     SourceStatus::Status Tick(SourceConfiguration::Configuration& config,
-                              const s16_le (&adpcm_coeffs)[16]);
+                              const s16_le (&adpcm_coeffs)[16], bool discard_output);
 
     /**
      * Mix this source's output into dest, using the gains for the `intermediate_mix_id`-th
@@ -56,7 +60,9 @@ public:
 
 private:
     const std::size_t source_id;
+    DecodedBufferCache& buffer_cache;
     StereoFrame16 current_frame;
+    bool discard_output = false;
 
     using Format = SourceConfiguration::Configuration::Format;
     using InterpolationMode = SourceConfiguration::Configuration::InterpolationMode;
@@ -108,7 +114,11 @@ private:
 
         u32 current_sample_number = 0;
         u32 next_sample_number = 0;
-        AudioInterp::StereoBuffer16 current_buffer;
+        /// Decoded samples of the current buffer, preceded by the two historical samples of the
+        /// interpolator. Its storage is reused for every buffer.
+        StereoBuffer16 current_buffer;
+        /// Position of the historical samples in current_buffer
+        std::size_t current_buffer_position = 0;
 
         // buffer_id state
 
@@ -138,6 +148,8 @@ private:
     void ParseConfig(SourceConfiguration::Configuration& config, const s16_le (&adpcm_coeffs)[16]);
     /// INTERNAL: Generate the current audio output for this frame based on our internal state.
     void GenerateFrame();
+    /// INTERNAL: Returns whether all samples of current_buffer have been consumed.
+    bool IsCurrentBufferEmpty() const;
     /// INTERNAL: Dequeues a buffer and does preprocessing on it (decoding, resampling). Puts it
     /// into current_buffer.
     bool DequeueBuffer();
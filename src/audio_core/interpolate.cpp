@@ -3,6 +3,10 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
 
@@ -15,63 +19,150 @@ constexpr u64 scale_factor = 1 << 24;
 constexpr u64 scale_mask = scale_factor - 1;
 
 /// Here we step over the input in steps of rate, until we consume all of the input.
-/// Three adjacent samples are passed to fn each step.
-template <typename Function>
-static void StepOverSamples(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-                            std::size_t& outputi, Function fn) {
+/// Three adjacent samples are passed to fn each step. While at least block_size output samples
+/// can be produced, block_fn is used instead to produce them at once.
+/// The input starts with the two historical samples, so no samples have to be moved around.
+template <std::size_t block_size, typename Function, typename BlockFunction>
+static void StepOverSamples(State& state, const StereoBuffer16& input, std::size_t& inputi,
+                            float rate, StereoFrame16& output, std::size_t& outputi, Function fn,
+                            BlockFunction block_fn) {
     ASSERT(rate > 0);
+    ASSERT(inputi + 2 <= input.size());
 
-    if (input.empty())
+    if (inputi + 2 == input.size())
         return;
 
-    input.insert(input.begin(), {state.xn2, state.xn1});
+    const std::array<s16, 2>* const samples = input.data() + inputi;
+    const std::size_t num_samples = input.size() - inputi;
 
     const u64 step_size = static_cast<u64>(rate * scale_factor);
     u64 fposition = state.fposition;
-    std::size_t inputi = 0;
+    std::size_t samplei = 0;
+
+    while (outputi + block_size <= output.size()) {
+        const u64 last_fposition = fposition + (block_size - 1) * step_size;
+        const auto last_samplei = static_cast<std::size_t>(last_fposition / scale_factor);
+        if (last_samplei + 2 >= num_samples)
+            break;
+
+        block_fn(samples, fposition, step_size, &output[outputi]);
+        outputi += block_size;
+        fposition = last_fposition + step_size;
+        samplei = last_samplei;
+    }
 
     while (outputi < output.size()) {
-        inputi = static_cast<std::size_t>(fposition / scale_factor);
+        samplei = static_cast<std::size_t>(fposition / scale_factor);
 
-        if (inputi + 2 >= input.size()) {
-            inputi = input.size() - 2;
+        if (samplei + 2 >= num_samples) {
+            samplei = num_samples - 2;
             break;
         }
 
         u64 fraction = fposition & scale_mask;
-        output[outputi++] = fn(fraction, input[inputi], input[inputi + 1], input[inputi + 2]);
+        output[outputi++] =
+            fn(fraction, samples[samplei], samples[samplei + 1], samples[samplei + 2]);
 
         fposition += step_size;
     }
 
-    state.xn2 = input[inputi];
-    state.xn1 = input[inputi + 1];
-    state.fposition = fposition - inputi * scale_factor;
+    state.xn2 = samples[samplei];
+    state.xn1 = samples[samplei + 1];
+    state.fposition = fposition - samplei * scale_factor;
+
+    inputi += samplei;
+}
+
+/// Number of output samples produced at once by the interpolation kernels
+constexpr std::size_t block_size = 4;
+
+void None(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+          StereoFrame16& output, std::size_t& outputi) {
+    StepOverSamples<block_size>(
+        state, input, inputi, rate, output, outputi,
+        [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) { return x0; },
+        [](const std::array<s16, 2>* samples, u64 fposition, u64 step_size,
+           std::array<s16, 2>* out) {
+            for (std::size_t i = 0; i < block_size; ++i, fposition += step_size) {
+                out[i] = samples[fposition / scale_factor];
+            }
+        });
+}
+
+static std::array<s16, 2> LinearSample(u64 fraction, const std::array<s16, 2>& x0,
+                                       const std::array<s16, 2>& x1) {
+    // This is a saturated subtraction. (Verified by black-box fuzzing.)
+    s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
+    s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
 
-    input.erase(input.begin(), std::next(input.begin(), inputi + 2));
+    return std::array<s16, 2>{
+        static_cast<s16>(x0[0] + fraction * delta0 / scale_factor),
+        static_cast<s16>(x0[1] + fraction * delta1 / scale_factor),
+    };
 }
 
-void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-          std::size_t& outputi) {
-    StepOverSamples(
-        state, input, rate, output, outputi,
-        [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) { return x0; });
+static void LinearBlock(const std::array<s16, 2>* samples, u64 fposition, u64 step_size,
+                        std::array<s16, 2>* out) {
+#ifdef ARCHITECTURE_x86_64
+    // The unsigned arithmetic of LinearSample makes fraction * delta / scale_factor round towards
+    // negative infinity. That is computed here in 32 bits by splitting the fraction into two 12 bit
+    // halves: floor((hi * 2^12 + lo) * delta / 2^24) == (hi * delta + (lo * delta >> 12)) >> 12
+    alignas(16) std::array<u32, block_size> x0;
+    alignas(16) std::array<u32, block_size> x1;
+    alignas(16) std::array<s16, block_size * 2> fraction_hi;
+    alignas(16) std::array<s16, block_size * 2> fraction_lo;
+    for (std::size_t i = 0; i < block_size; ++i, fposition += step_size) {
+        const std::size_t samplei = static_cast<std::size_t>(fposition / scale_factor);
+        std::memcpy(&x0[i], &samples[samplei], sizeof(u32));
+        std::memcpy(&x1[i], &samples[samplei + 1], sizeof(u32));
+        const u64 fraction = fposition & scale_mask;
+        fraction_hi[i * 2] = fraction_hi[i * 2 + 1] = static_cast<s16>(fraction >> 12);
+        fraction_lo[i * 2] = fraction_lo[i * 2 + 1] = static_cast<s16>(fraction & 0xFFF);
+    }
+
+    const __m128i x0_16 = _mm_load_si128(reinterpret_cast<const __m128i*>(x0.data()));
+    const __m128i x1_16 = _mm_load_si128(reinterpret_cast<const __m128i*>(x1.data()));
+    const __m128i delta = _mm_subs_epi16(x1_16, x0_16);
+
+    const auto multiply = [&delta](const std::array<s16, block_size * 2>& fraction, __m128i& low,
+                                   __m128i& high) {
+        const __m128i f = _mm_load_si128(reinterpret_cast<const __m128i*>(fraction.data()));
+        const __m128i product_lo = _mm_mullo_epi16(delta, f);
+        const __m128i product_hi = _mm_mulhi_epi16(delta, f);
+        low = _mm_unpacklo_epi16(product_lo, product_hi);
+        high = _mm_unpackhi_epi16(product_lo, product_hi);
+    };
+    __m128i hi_low, hi_high, lo_low, lo_high;
+    multiply(fraction_hi, hi_low, hi_high);
+    multiply(fraction_lo, lo_low, lo_high);
+
+    const __m128i step_low = _mm_srai_epi32(_mm_add_epi32(hi_low, _mm_srai_epi32(lo_low, 12)), 12);
+    const __m128i step_high =
+        _mm_srai_epi32(_mm_add_epi32(hi_high, _mm_srai_epi32(lo_high, 12)), 12);
+
+    // The results lie between x0 and x1, so the saturating pack doesn't change them
+    const __m128i x0_low = _mm_srai_epi32(_mm_unpacklo_epi16(x0_16, x0_16), 16);
+    const __m128i x0_high = _mm_srai_epi32(_mm_unpackhi_epi16(x0_16, x0_16), 16);
+    const __m128i result =
+        _mm_packs_epi32(_mm_add_epi32(x0_low, step_low), _mm_add_epi32(x0_high, step_high));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), result);
+#else
+    for (std::size_t i = 0; i < block_size; ++i, fposition += step_size) {
+        const std::size_t samplei = static_cast<std::size_t>(fposition / scale_factor);
+        out[i] = LinearSample(fposition & scale_mask, samples[samplei], samples[samplei + 1]);
+    }
+#endif
 }
 
-void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-            std::size_t& outputi) {
+void Linear(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+            StereoFrame16& output, std::size_t& outputi) {
     // Note on accuracy: Some values that this produces are +/- 1 from the actual firmware.
-    StepOverSamples(state, input, rate, output, outputi,
-                    [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) {
-                        // This is a saturated subtraction. (Verified by black-box fuzzing.)
-                        s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
-                        s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
-
-                        return std::array<s16, 2>{
-                            static_cast<s16>(x0[0] + fraction * delta0 / scale_factor),
-                            static_cast<s16>(x0[1] + fraction * delta1 / scale_factor),
-                        };
-                    });
+    StepOverSamples<block_size>(
+        state, input, inputi, rate, output, outputi,
+        [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) {
+            return LinearSample(fraction, x0, x1);
+        },
+        LinearBlock);
 }
 
 } // namespace AudioInterp
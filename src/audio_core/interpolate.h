@@ -5,16 +5,13 @@
 #pragma once
 
 #include <array>
-#include <deque>
+#include <cstddef>
 #include "audio_core/audio_types.h"
 #include "common/common_types.h"
 
 namespace AudioCore {
 namespace AudioInterp {
 
-/// A variable length buffer of signed PCM16 stereo samples.
-using StereoBuffer16 = std::deque<std::array<s16, 2>>;
-
 struct State {
     /// Two historical samples.
     std::array<s16, 2> xn1 = {}; ///< x[n-1]
@@ -26,26 +23,32 @@ struct State {
 /**
  * No interpolation. This is equivalent to a zero-order hold. There is a two-sample predelay.
  * @param state Interpolation state.
- * @param input Input buffer.
+ * @param input Input buffer. The two samples at inputi are the historical samples of state,
+ *              followed by the samples which have not been consumed yet.
+ * @param inputi The index of input to start reading from. This is advanced past the consumed
+ *               samples, keeping the two new historical samples.
  * @param rate Stretch factor. Must be a positive non-zero value.
  *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
  * @param output The resampled audio buffer.
  * @param outputi The index of output to start writing to.
  */
-void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-          std::size_t& outputi);
+void None(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+          StereoFrame16& output, std::size_t& outputi);
 
 /**
  * Linear interpolation. This is equivalent to a first-order hold. There is a two-sample predelay.
  * @param state Interpolation state.
- * @param input Input buffer.
+ * @param input Input buffer. The two samples at inputi are the historical samples of state,
+ *              followed by the samples which have not been consumed yet.
+ * @param inputi The index of input to start reading from. This is advanced past the consumed
+ *               samples, keeping the two new historical samples.
  * @param rate Stretch factor. Must be a positive non-zero value.
  *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
  * @param output The resampled audio buffer.
  * @param outputi The index of output to start writing to.
  */
-void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-            std::size_t& outputi);
+void Linear(State& state, const StereoBuffer16& input, std::size_t& inputi, float rate,
+            StereoFrame16& output, std::size_t& outputi);
 
 } // namespace AudioInterp
 } // namespace AudioCore
@@ -20,6 +20,10 @@ public:
     }
 
     void SetCallback(std::function<void(s16*, std::size_t)>) override {}
+
+    bool DiscardsOutput() const override {
+        return true;
+    }
 };
 
 } // namespace AudioCore
@@ -30,6 +30,22 @@ public:
      * @param sample_count Number of samples.
      */
     virtual void SetCallback(std::function<void(s16*, std::size_t)> cb) = 0;
+
+    /**
+     * Offers every frame of samples produced by the DSP to the sink before it is queued for the
+     * callback. Sinks that record the output stream as it is produced take the samples here.
+     * @param samples Samples in interleaved stereo PCM16 format.
+     * @param sample_count Number of samples.
+     * @returns true if the sink took the samples, which are then not queued for the callback.
+     */
+    virtual bool PushSamples(const s16* samples, std::size_t sample_count) {
+        return false;
+    }
+
+    /// Returns true if the sink throws away all samples, so that they do not need to be generated
+    virtual bool DiscardsOutput() const {
+        return false;
+    }
 };
 
 } // namespace AudioCore
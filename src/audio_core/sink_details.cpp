@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "audio_core/file_sink.h"
 #include "audio_core/null_sink.h"
 #include "audio_core/sink_details.h"
 #ifdef HAVE_SDL2
@@ -28,6 +29,8 @@ const std::vector<SinkDetails> g_sink_details = {
 #endif
     SinkDetails{"null", &std::make_unique<NullSink, std::string>,
                 [] { return std::vector<std::string>{"null"}; }},
+    // Only used when explicitly selected, never picked by auto-selection
+    SinkDetails{"file", &std::make_unique<FileSink, std::string>, &ListFileSinkDevices},
 };
 
 const SinkDetails& GetSinkDetails(std::string_view sink_id) {
@@ -9,22 +9,120 @@
 #include <SoundTouch.h>
 #include "audio_core/audio_types.h"
 #include "audio_core/time_stretch.h"
+#include "audio_core/wsola.h"
 #include "common/logging/log.h"
 
 namespace AudioCore {
 
-TimeStretcher::TimeStretcher()
-    : sample_rate(native_sample_rate), sound_touch(std::make_unique<soundtouch::SoundTouch>()) {
-    sound_touch->setChannels(2);
-    sound_touch->setSampleRate(native_sample_rate);
-    sound_touch->setPitch(1.0);
-    sound_touch->setTempo(1.0);
+/// Algorithm changing the tempo of the audio, fed by TimeStretcher
+class TimeStretchBackend {
+public:
+    virtual ~TimeStretchBackend() = default;
+    virtual void SetSampleRate(unsigned int sample_rate) = 0;
+    virtual void SetTempo(double tempo) = 0;
+    virtual void PutSamples(const s16* in, std::size_t num_in) = 0;
+    virtual std::size_t ReceiveSamples(s16* out, std::size_t num_out) = 0;
+    virtual std::size_t NumSamples() const = 0;
+    virtual void Clear() = 0;
+    virtual void Flush() = 0;
+};
+
+namespace {
+
+class SoundTouchBackend final : public TimeStretchBackend {
+public:
+    SoundTouchBackend() {
+        sound_touch.setChannels(2);
+        sound_touch.setSampleRate(native_sample_rate);
+        sound_touch.setPitch(1.0);
+        sound_touch.setTempo(1.0);
+    }
+
+    void SetSampleRate(unsigned int sample_rate) override {
+        sound_touch.setSampleRate(sample_rate);
+    }
+
+    void SetTempo(double tempo) override {
+        sound_touch.setTempo(tempo);
+    }
+
+    void PutSamples(const s16* in, std::size_t num_in) override {
+        sound_touch.putSamples(in, static_cast<u32>(num_in));
+    }
+
+    std::size_t ReceiveSamples(s16* out, std::size_t num_out) override {
+        return sound_touch.receiveSamples(out, static_cast<u32>(num_out));
+    }
+
+    std::size_t NumSamples() const override {
+        return sound_touch.numSamples();
+    }
+
+    void Clear() override {
+        sound_touch.clear();
+    }
+
+    void Flush() override {
+        sound_touch.flush();
+    }
+
+private:
+    soundtouch::SoundTouch sound_touch;
+};
+
+class WSOLABackend final : public TimeStretchBackend {
+public:
+    void SetSampleRate(unsigned int sample_rate) override {
+        wsola.SetSampleRate(sample_rate);
+    }
+
+    void SetTempo(double tempo) override {
+        wsola.SetTempo(tempo);
+    }
+
+    void PutSamples(const s16* in, std::size_t num_in) override {
+        wsola.PutSamples(in, num_in);
+    }
+
+    std::size_t ReceiveSamples(s16* out, std::size_t num_out) override {
+        return wsola.ReceiveSamples(out, num_out);
+    }
+
+    std::size_t NumSamples() const override {
+        return wsola.NumSamples();
+    }
+
+    void Clear() override {
+        wsola.Clear();
+    }
+
+    void Flush() override {
+        wsola.Flush();
+    }
+
+private:
+    WSOLAStretcher wsola;
+};
+
+} // anonymous namespace
+
+TimeStretcher::TimeStretcher(Settings::TimeStretchAlgorithm algorithm)
+    : sample_rate(native_sample_rate) {
+    switch (algorithm) {
+    case Settings::TimeStretchAlgorithm::WSOLA:
+        backend = std::make_unique<WSOLABackend>();
+        break;
+    case Settings::TimeStretchAlgorithm::SoundTouch:
+    default:
+        backend = std::make_unique<SoundTouchBackend>();
+        break;
+    }
 }
 
 TimeStretcher::~TimeStretcher() = default;
 
 void TimeStretcher::SetOutputSampleRate(unsigned int sample_rate) {
-    sound_touch->setSampleRate(sample_rate);
+    backend->SetSampleRate(sample_rate);
     sample_rate = native_sample_rate;
 }
 
@@ -35,7 +133,7 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
 
     const double max_latency = 0.25; // seconds
     const double max_backlog = sample_rate * max_latency;
-    const double backlog_fullness = sound_touch->numSamples() / max_backlog;
+    const double backlog_fullness = backend->NumSamples() / max_backlog;
     if (backlog_fullness > 4.0) {
         // Too many samples in backlog: Don't push anymore on
         num_in = 0;
@@ -57,21 +155,21 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
     // Place a lower limit of 5% speed.  When a game boots up, there will be
     // many silence samples.  These do not need to be timestretched.
     stretch_ratio = std::max(stretch_ratio, 0.05);
-    sound_touch->setTempo(stretch_ratio);
+    backend->SetTempo(stretch_ratio);
 
     LOG_TRACE(Audio, "{:5}/{:5} ratio:{:0.6f} backlog:{:0.6f}", num_in, num_out, stretch_ratio,
               backlog_fullness);
 
-    sound_touch->putSamples(in, static_cast<u32>(num_in));
-    return sound_touch->receiveSamples(out, static_cast<u32>(num_out));
+    backend->PutSamples(in, num_in);
+    return backend->ReceiveSamples(out, num_out);
 }
 
 void TimeStretcher::Clear() {
-    sound_touch->clear();
+    backend->Clear();
 }
 
 void TimeStretcher::Flush() {
-    sound_touch->flush();
+    backend->Flush();
 }
 
 } // namespace AudioCore
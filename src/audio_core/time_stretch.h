@@ -8,16 +8,15 @@
 #include <cstddef>
 #include <memory>
 #include "common/common_types.h"
-
-namespace soundtouch {
-class SoundTouch;
-}
+#include "core/settings.h"
 
 namespace AudioCore {
 
+class TimeStretchBackend;
+
 class TimeStretcher {
 public:
-    TimeStretcher();
+    explicit TimeStretcher(Settings::TimeStretchAlgorithm algorithm);
     ~TimeStretcher();
 
     void SetOutputSampleRate(unsigned int sample_rate);
@@ -33,9 +32,14 @@ public:
 
     void Flush();
 
+    /// Returns the tempo ratio applied by the last call to Process
+    double GetStretchRatio() const {
+        return stretch_ratio;
+    }
+
 private:
     unsigned int sample_rate;
-    std::unique_ptr<soundtouch::SoundTouch> sound_touch;
+    std::unique_ptr<TimeStretchBackend> backend;
     double stretch_ratio = 1.0;
 };
 
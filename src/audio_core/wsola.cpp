@@ -0,0 +1,203 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
+#include "audio_core/audio_types.h"
+#include "audio_core/wsola.h"
+
+namespace AudioCore {
+
+namespace {
+
+/// Amount of audio the buffers are allocated for, more than TimeStretcher ever lets queue up
+constexpr std::size_t MAX_BUFFERED_SECONDS = 2;
+
+/// Computes the correlation of two blocks of samples, and the energy of the second one
+void Correlate(const s16* ref, const s16* in, std::size_t count, float& corr, float& energy) {
+    // The samples are halved so that the sum of two products fits into 32 bits
+#ifdef ARCHITECTURE_x86_64
+    __m128 corr_sum = _mm_setzero_ps();
+    __m128 energy_sum = _mm_setzero_ps();
+    for (std::size_t i = 0; i < count; i += 8) {
+        const __m128i a =
+            _mm_srai_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ref + i)), 1);
+        const __m128i b =
+            _mm_srai_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), 1);
+        corr_sum = _mm_add_ps(corr_sum, _mm_cvtepi32_ps(_mm_madd_epi16(a, b)));
+        energy_sum = _mm_add_ps(energy_sum, _mm_cvtepi32_ps(_mm_madd_epi16(b, b)));
+    }
+
+    alignas(16) float corr_lanes[4];
+    alignas(16) float energy_lanes[4];
+    _mm_store_ps(corr_lanes, corr_sum);
+    _mm_store_ps(energy_lanes, energy_sum);
+    corr = (corr_lanes[0] + corr_lanes[1]) + (corr_lanes[2] + corr_lanes[3]);
+    energy = (energy_lanes[0] + energy_lanes[1]) + (energy_lanes[2] + energy_lanes[3]);
+#else
+    corr = 0.0f;
+    energy = 0.0f;
+    for (std::size_t i = 0; i < count; i += 2) {
+        const s32 a0 = ref[i] >> 1, a1 = ref[i + 1] >> 1;
+        const s32 b0 = in[i] >> 1, b1 = in[i + 1] >> 1;
+        corr += static_cast<float>(a0 * b0 + a1 * b1);
+        energy += static_cast<float>(b0 * b0 + b1 * b1);
+    }
+#endif
+}
+
+/**
+ * Drops the consumed samples at the front of a buffer once they make up at least half of it, so
+ * that consuming samples costs constant time on average instead of moving the whole buffer.
+ */
+void DropConsumed(std::vector<s16>& buffer, std::size_t& position) {
+    if (position * 2 < buffer.size())
+        return;
+    buffer.erase(buffer.begin(), buffer.begin() + position);
+    position = 0;
+}
+
+} // anonymous namespace
+
+WSOLAStretcher::WSOLAStretcher(unsigned int sequence_ms, unsigned int seek_window_ms,
+                               unsigned int overlap_ms)
+    : sequence_ms(sequence_ms), seek_window_ms(seek_window_ms), overlap_ms(overlap_ms) {
+    SetSampleRate(native_sample_rate);
+}
+
+void WSOLAStretcher::SetSampleRate(unsigned int sample_rate) {
+    // The correlation processes eight samples, or four frames, at a time
+    overlap_length = std::max<std::size_t>(sample_rate * overlap_ms / 1000 / 4 * 4, 4);
+    sequence_length = std::max<std::size_t>(sample_rate * sequence_ms / 1000, 2 * overlap_length);
+    seek_length = std::max<std::size_t>(sample_rate * seek_window_ms / 1000, 1);
+
+    // Consumed samples are only dropped once they fill half of a buffer, hence twice the size
+    input.reserve((sample_rate * MAX_BUFFERED_SECONDS + seek_length + sequence_length) * 2 * 2);
+    output.reserve(sample_rate * MAX_BUFFERED_SECONDS * 2 * 2);
+    overlap.assign(overlap_length * 2, 0);
+
+    Clear();
+    SetTempo(tempo);
+}
+
+void WSOLAStretcher::SetTempo(double tempo_) {
+    tempo = tempo_;
+    nominal_skip = (sequence_length - overlap_length) * tempo;
+}
+
+void WSOLAStretcher::PutSamples(const s16* in, std::size_t num_in) {
+    DropConsumed(input, input_position);
+    input.insert(input.end(), in, in + num_in * 2);
+    ProcessSegments();
+}
+
+std::size_t WSOLAStretcher::ReceiveSamples(s16* out, std::size_t num_out) {
+    const std::size_t frames = std::min(num_out, NumSamples());
+    std::copy_n(output.begin() + output_position, frames * 2, out);
+    output_position += frames * 2;
+    DropConsumed(output, output_position);
+    return frames;
+}
+
+std::size_t WSOLAStretcher::NumSamples() const {
+    return (output.size() - output_position) / 2;
+}
+
+void WSOLAStretcher::Clear() {
+    input.clear();
+    output.clear();
+    input_position = 0;
+    output_position = 0;
+    skip_fraction = 0.0;
+    first_segment = true;
+}
+
+void WSOLAStretcher::Flush() {
+    const auto input_begin = input.begin() + input_position;
+    if (!first_segment) {
+        if (InputFrames() >= overlap_length) {
+            AppendCrossfade(&*input_begin);
+            output.insert(output.end(), input_begin + overlap_length * 2, input.end());
+        } else {
+            output.insert(output.end(), overlap.begin(), overlap.end());
+            output.insert(output.end(), input_begin, input.end());
+        }
+    } else {
+        output.insert(output.end(), input_begin, input.end());
+    }
+
+    input.clear();
+    input_position = 0;
+    skip_fraction = 0.0;
+    first_segment = true;
+}
+
+void WSOLAStretcher::ProcessSegments() {
+    while (true) {
+        const double position = skip_fraction + nominal_skip;
+        const std::size_t advance = static_cast<std::size_t>(position);
+        if (InputFrames() < std::max(seek_length + sequence_length, advance))
+            break;
+
+        const s16* const input_begin = input.data() + input_position;
+
+        // Each segment produces sequence_length - overlap_length frames of output, the last
+        // overlap_length frames are kept to be crossfaded into the start of the next segment
+        std::size_t offset = 0;
+        if (first_segment) {
+            output.insert(output.end(), input_begin,
+                          input_begin + (sequence_length - overlap_length) * 2);
+            first_segment = false;
+        } else {
+            offset = FindBestOffset();
+            const s16* segment = input_begin + offset * 2;
+            AppendCrossfade(segment);
+            output.insert(output.end(), segment + overlap_length * 2,
+                          segment + (sequence_length - overlap_length) * 2);
+        }
+
+        const s16* overlap_begin = input_begin + (offset + sequence_length - overlap_length) * 2;
+        std::copy_n(overlap_begin, overlap_length * 2, overlap.begin());
+
+        skip_fraction = position - advance;
+        input_position += advance * 2;
+    }
+}
+
+std::size_t WSOLAStretcher::FindBestOffset() const {
+    std::size_t best_offset = 0;
+    float best_score = std::numeric_limits<float>::lowest();
+    for (std::size_t offset = 0; offset < seek_length; ++offset) {
+        float corr, energy;
+        Correlate(overlap.data(), input.data() + input_position + offset * 2, overlap_length * 2,
+                  corr, energy);
+        const float score = corr / std::sqrt(energy + 1.0f);
+        if (score > best_score) {
+            best_score = score;
+            best_offset = offset;
+        }
+    }
+    return best_offset;
+}
+
+std::size_t WSOLAStretcher::InputFrames() const {
+    return (input.size() - input_position) / 2;
+}
+
+void WSOLAStretcher::AppendCrossfade(const s16* in) {
+    const s32 length = static_cast<s32>(overlap_length);
+    for (s32 i = 0; i < length; ++i) {
+        for (s32 channel = 0; channel < 2; ++channel) {
+            const s32 fade_out = overlap[i * 2 + channel] * (length - i);
+            const s32 fade_in = in[i * 2 + channel] * i;
+            output.push_back(static_cast<s16>((fade_out + fade_in) / length));
+        }
+    }
+}
+
+} // namespace AudioCore
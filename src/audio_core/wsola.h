@@ -0,0 +1,93 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "common/common_types.h"
+
+namespace AudioCore {
+
+/**
+ * Changes the tempo of stereo PCM16 audio without changing its pitch, using waveform similarity
+ * based overlap-add (WSOLA). Segments of the input are copied to the output and crossfaded with
+ * each other, each segment being taken from the position within the seek window whose waveform
+ * best matches the end of the previous segment.
+ *
+ * All buffers are allocated up front when the sample rate is set, so that the sink thread does not
+ * allocate while stretching.
+ */
+class WSOLAStretcher {
+public:
+    /**
+     * @param sequence_ms Length of the segments of input copied to the output, in milliseconds
+     * @param seek_window_ms Length of the range searched for the best matching segment
+     * @param overlap_ms Length of the crossfade between consecutive segments
+     */
+    explicit WSOLAStretcher(unsigned int sequence_ms = 40, unsigned int seek_window_ms = 15,
+                            unsigned int overlap_ms = 8);
+
+    void SetSampleRate(unsigned int sample_rate);
+
+    /// Sets the ratio of the input length to the output length
+    void SetTempo(double tempo);
+
+    /// @param in      Input sample buffer
+    /// @param num_in  Number of input frames in `in`
+    void PutSamples(const s16* in, std::size_t num_in);
+
+    /// @param out      Output sample buffer
+    /// @param num_out  Maximum number of frames to write to `out`
+    /// @returns Actual number of frames written to `out`
+    std::size_t ReceiveSamples(s16* out, std::size_t num_out);
+
+    /// Returns the number of frames ready to be received
+    std::size_t NumSamples() const;
+
+    /// Discards all buffered input and output
+    void Clear();
+
+    /// Makes all buffered input available as output
+    void Flush();
+
+private:
+    /// Stretches as many segments of the buffered input as possible
+    void ProcessSegments();
+
+    /// Returns the offset into the input of the segment best matching the overlap buffer
+    std::size_t FindBestOffset() const;
+
+    /// Returns the number of input frames not consumed yet
+    std::size_t InputFrames() const;
+
+    /// Crossfades the overlap buffer into the input frames at in, appending the result to output
+    void AppendCrossfade(const s16* in);
+
+    unsigned int sequence_ms;
+    unsigned int seek_window_ms;
+    unsigned int overlap_ms;
+
+    // Lengths in frames at the current sample rate
+    std::size_t sequence_length = 0;
+    std::size_t seek_length = 0;
+    std::size_t overlap_length = 0;
+
+    double tempo = 1.0;
+    /// Number of input frames to advance by for each segment, in frames
+    double nominal_skip = 0.0;
+    /// Fractional part of the input position carried over to the next segment
+    double skip_fraction = 0.0;
+    bool first_segment = true;
+
+    std::vector<s16> input;
+    std::vector<s16> output;
+    /// Index of the first sample of input and output that has not been consumed yet
+    std::size_t input_position = 0;
+    std::size_t output_position = 0;
+    /// End of the previous segment, crossfaded into the start of the next one
+    std::vector<s16> overlap;
+};
+
+} // namespace AudioCore
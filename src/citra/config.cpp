@@ -116,6 +116,28 @@ void Config::ReadValues() {
         sdl2_config->GetBoolean("Renderer", "shaders_accurate_gs", true);
     Settings::values.shaders_accurate_mul =
         sdl2_config->GetBoolean("Renderer", "shaders_accurate_mul", false);
+    Settings::values.use_disk_shader_cache =
+        sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", true);
+    Settings::values.use_async_shader_compilation =
+        sdl2_config->GetBoolean("Renderer", "use_async_shader_compilation", false);
+    Settings::values.use_uber_shader =
+        sdl2_config->GetBoolean("Renderer", "use_uber_shader", false);
+    Settings::values.uber_shader_titles.clear();
+    std::istringstream uber_shader_titles(
+        sdl2_config->GetString("Renderer", "uber_shader_titles", ""));
+    std::string title_id;
+    while (std::getline(uber_shader_titles, title_id, ',')) {
+        std::istringstream title_id_stream(title_id);
+        u64 value = 0;
+        title_id_stream >> std::hex >> value;
+        if (value != 0) {
+            Settings::values.uber_shader_titles.push_back(value);
+        } else {
+            LOG_ERROR(Config, "Failed to parse uber_shader_titles entry \"{}\"", title_id);
+        }
+    }
+    Settings::values.use_texture_deduplication =
+        sdl2_config->GetBoolean("Renderer", "use_texture_deduplication", false);
     Settings::values.use_shader_jit = sdl2_config->GetBoolean("Renderer", "use_shader_jit", true);
     Settings::values.resolution_factor =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "resolution_factor", 1));
@@ -158,6 +180,14 @@ void Config::ReadValues() {
     Settings::values.sink_id = sdl2_config->GetString("Audio", "output_engine", "auto");
     Settings::values.enable_audio_stretching =
         sdl2_config->GetBoolean("Audio", "enable_audio_stretching", true);
+    Settings::values.time_stretch_algorithm = static_cast<Settings::TimeStretchAlgorithm>(
+        sdl2_config->GetInteger("Audio", "time_stretch_algorithm", 0));
+    Settings::values.enable_dsp_multithreading =
+        sdl2_config->GetBoolean("Audio", "enable_dsp_multithreading", false);
+    Settings::values.enable_audio_pacing =
+        sdl2_config->GetBoolean("Audio", "enable_audio_pacing", false);
+    Settings::values.audio_latency =
+        static_cast<u16>(sdl2_config->GetInteger("Audio", "audio_latency", 50));
     Settings::values.audio_device_id = sdl2_config->GetString("Audio", "output_device", "auto");
     Settings::values.volume = sdl2_config->GetReal("Audio", "volume", 1);
 
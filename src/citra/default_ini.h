@@ -106,6 +106,29 @@ shaders_accurate_mul =
 # 0: Off (Faster, but causes issues in some games) 1: On (Default. Slower, but correct)
 shaders_accurate_gs =
 
+# Whether to store generated hardware shaders on disk to reduce stutter in later sessions
+# 0: Off, 1 (default): On
+use_disk_shader_cache =
+
+# Whether to compile new fragment shaders in the background, drawing with a generic shader until
+# they are ready. Only used when the driver supports parallel shader compilation
+# 0 (default): Off, 1: On
+use_async_shader_compilation =
+
+# Whether to draw with a single generic fragment shader instead of compiling one per Pica
+# configuration. Avoids compilation stutter at the cost of slower draws
+# 0 (default): Off, 1: On
+use_uber_shader =
+
+# Comma separated list of hexadecimal title ids that always use the uber shader,
+# e.g. 0004000000030800,000400000008C300
+uber_shader_titles =
+
+# Whether to reuse the texture of a surface with identical content instead of loading a texture
+# from emulated memory again. Costs a hash of every loaded texture
+# 0 (default): Off, 1: On
+use_texture_deduplication =
+
 # Whether to use the Just-In-Time (JIT) compiler for shader emulation
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
@@ -169,6 +192,7 @@ swap_screen =
 [Audio]
 # Which audio output engine to use.
 # auto (default): Auto-select, null: No audio output, sdl2: SDL2 (if available)
+# file: Record the audio output to a file, see output_device
 output_engine =
 
 # Whether or not to enable the audio-stretching post-processing effect.
@@ -177,8 +201,31 @@ output_engine =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# Which algorithm to use for audio stretching. Takes effect when emulation is started.
+# 0 (default): SoundTouch, 1: WSOLA (built in)
+time_stretch_algorithm =
+
+# Whether to process the audio sources of the emulated DSP on several threads.
+# The audio output is the same either way.
+# 0 (default): No, 1: Yes
+enable_dsp_multithreading =
+
+# Whether to pace emulation on the audio output instead of the system clock.
+# Emulation is throttled to keep the queued audio at the latency target, which keeps the audio
+# free of gaps without audio stretching. Only applies while the frame limit is set to 100%.
+# 0 (default): No, 1: Yes
+enable_audio_pacing =
+
+# Amount of audio queued for output when pacing emulation on the audio output, in milliseconds.
+# Lower values reduce the audio latency, but need a steadier emulation speed.
+# 10 - 250: Latency target. 50 (default)
+audio_latency =
+
 # Which audio device to use.
 # auto (default): Auto-select
+# For the file engine, wav or raw record to audio_dump.wav or audio_dump.raw in the user directory,
+# any other value is the path of the file to record to. The hash of every audio frame is written to
+# a .hashes file next to it.
 output_device =
 
 # Output volume.
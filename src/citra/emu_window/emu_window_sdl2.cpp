@@ -237,6 +237,44 @@ void EmuWindow_SDL2::PollEvents() {
     }
 }
 
+namespace {
+
+class SharedContext_SDL2 : public GraphicsContext {
+public:
+    SharedContext_SDL2(SDL_Window* window, SDL_GLContext context)
+        : window(window), context(context) {}
+
+    ~SharedContext_SDL2() override {
+        SDL_GL_DeleteContext(context);
+    }
+
+    void MakeCurrent() override {
+        SDL_GL_MakeCurrent(window, context);
+    }
+
+    void DoneCurrent() override {
+        SDL_GL_MakeCurrent(window, nullptr);
+    }
+
+private:
+    SDL_Window* window;
+    SDL_GLContext context;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<GraphicsContext> EmuWindow_SDL2::CreateSharedContext() const {
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+    SDL_GLContext context = SDL_GL_CreateContext(render_window);
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+
+    if (context == nullptr) {
+        LOG_ERROR(Frontend, "Failed to create shared SDL2 GL context: {}", SDL_GetError());
+        return nullptr;
+    }
+    return std::make_unique<SharedContext_SDL2>(render_window, context);
+}
+
 void EmuWindow_SDL2::MakeCurrent() {
     SDL_GL_MakeCurrent(render_window, gl_context);
 }
@@ -106,6 +106,16 @@ void Config::ReadValues() {
 #endif
     Settings::values.shaders_accurate_gs = ReadSetting("shaders_accurate_gs", true).toBool();
     Settings::values.shaders_accurate_mul = ReadSetting("shaders_accurate_mul", false).toBool();
+    Settings::values.use_disk_shader_cache = ReadSetting("use_disk_shader_cache", true).toBool();
+    Settings::values.use_async_shader_compilation =
+        ReadSetting("use_async_shader_compilation", false).toBool();
+    Settings::values.use_uber_shader = ReadSetting("use_uber_shader", false).toBool();
+    Settings::values.uber_shader_titles.clear();
+    for (const QString& title_id : ReadSetting("uber_shader_titles").toStringList()) {
+        Settings::values.uber_shader_titles.push_back(title_id.toULongLong(nullptr, 16));
+    }
+    Settings::values.use_texture_deduplication =
+        ReadSetting("use_texture_deduplication", false).toBool();
     Settings::values.use_shader_jit = ReadSetting("use_shader_jit", true).toBool();
     Settings::values.resolution_factor =
         static_cast<u16>(ReadSetting("resolution_factor", 1).toInt());
@@ -139,6 +149,12 @@ void Config::ReadValues() {
     Settings::values.sink_id = ReadSetting("output_engine", "auto").toString().toStdString();
     Settings::values.enable_audio_stretching =
         ReadSetting("enable_audio_stretching", true).toBool();
+    Settings::values.time_stretch_algorithm = static_cast<Settings::TimeStretchAlgorithm>(
+        ReadSetting("time_stretch_algorithm", 0).toInt());
+    Settings::values.enable_dsp_multithreading =
+        ReadSetting("enable_dsp_multithreading", false).toBool();
+    Settings::values.enable_audio_pacing = ReadSetting("enable_audio_pacing", false).toBool();
+    Settings::values.audio_latency = static_cast<u16>(ReadSetting("audio_latency", 50).toInt());
     Settings::values.audio_device_id =
         ReadSetting("output_device", "auto").toString().toStdString();
     Settings::values.volume = ReadSetting("volume", 1).toFloat();
@@ -367,6 +383,17 @@ void Config::SaveValues() {
     WriteSetting("use_hw_shader", Settings::values.use_hw_shader, true);
     WriteSetting("shaders_accurate_gs", Settings::values.shaders_accurate_gs, true);
     WriteSetting("shaders_accurate_mul", Settings::values.shaders_accurate_mul, false);
+    WriteSetting("use_disk_shader_cache", Settings::values.use_disk_shader_cache, true);
+    WriteSetting("use_async_shader_compilation", Settings::values.use_async_shader_compilation,
+                 false);
+    WriteSetting("use_uber_shader", Settings::values.use_uber_shader, false);
+    QStringList uber_shader_titles;
+    for (u64 title_id : Settings::values.uber_shader_titles) {
+        uber_shader_titles.append(
+            QStringLiteral("%1").arg(title_id, 16, 16, QLatin1Char('0')).toUpper());
+    }
+    WriteSetting("uber_shader_titles", uber_shader_titles);
+    WriteSetting("use_texture_deduplication", Settings::values.use_texture_deduplication, false);
     WriteSetting("use_shader_jit", Settings::values.use_shader_jit, true);
     WriteSetting("resolution_factor", Settings::values.resolution_factor, 1);
     WriteSetting("use_vsync", Settings::values.use_vsync, false);
@@ -398,6 +425,11 @@ void Config::SaveValues() {
     qt_config->beginGroup("Audio");
     WriteSetting("output_engine", QString::fromStdString(Settings::values.sink_id), "auto");
     WriteSetting("enable_audio_stretching", Settings::values.enable_audio_stretching, true);
+    WriteSetting("time_stretch_algorithm",
+                 static_cast<int>(Settings::values.time_stretch_algorithm), 0);
+    WriteSetting("enable_dsp_multithreading", Settings::values.enable_dsp_multithreading, false);
+    WriteSetting("enable_audio_pacing", Settings::values.enable_audio_pacing, false);
+    WriteSetting("audio_latency", Settings::values.audio_latency, 50);
     WriteSetting("output_device", QString::fromStdString(Settings::values.audio_device_id), "auto");
     WriteSetting("volume", Settings::values.volume, 1.0f);
     qt_config->endGroup();
@@ -39,6 +39,11 @@ void ConfigureAudio::setConfiguration() {
     setAudioDeviceFromDeviceID();
 
     ui->toggle_audio_stretching->setChecked(Settings::values.enable_audio_stretching);
+    ui->time_stretch_algorithm_combobox->setCurrentIndex(
+        static_cast<int>(Settings::values.time_stretch_algorithm));
+    ui->toggle_dsp_multithreading->setChecked(Settings::values.enable_dsp_multithreading);
+    ui->toggle_audio_pacing->setChecked(Settings::values.enable_audio_pacing);
+    ui->audio_latency_spinbox->setValue(Settings::values.audio_latency);
     ui->volume_slider->setValue(Settings::values.volume * ui->volume_slider->maximum());
     setVolumeIndicatorText(ui->volume_slider->sliderPosition());
 }
@@ -80,6 +85,11 @@ void ConfigureAudio::applyConfiguration() {
         ui->output_sink_combo_box->itemText(ui->output_sink_combo_box->currentIndex())
             .toStdString();
     Settings::values.enable_audio_stretching = ui->toggle_audio_stretching->isChecked();
+    Settings::values.time_stretch_algorithm = static_cast<Settings::TimeStretchAlgorithm>(
+        ui->time_stretch_algorithm_combobox->currentIndex());
+    Settings::values.enable_dsp_multithreading = ui->toggle_dsp_multithreading->isChecked();
+    Settings::values.enable_audio_pacing = ui->toggle_audio_pacing->isChecked();
+    Settings::values.audio_latency = static_cast<u16>(ui->audio_latency_spinbox->value());
     Settings::values.audio_device_id =
         ui->audio_device_combo_box->itemText(ui->audio_device_combo_box->currentIndex())
             .toStdString();
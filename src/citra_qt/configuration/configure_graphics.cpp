@@ -59,6 +59,11 @@ void ConfigureGraphics::setConfiguration() {
     ui->toggle_hw_shader->setChecked(Settings::values.use_hw_shader);
     ui->toggle_accurate_gs->setChecked(Settings::values.shaders_accurate_gs);
     ui->toggle_accurate_mul->setChecked(Settings::values.shaders_accurate_mul);
+    ui->toggle_disk_shader_cache->setChecked(Settings::values.use_disk_shader_cache);
+    ui->toggle_async_shader_compilation->setChecked(
+        Settings::values.use_async_shader_compilation);
+    ui->toggle_uber_shader->setChecked(Settings::values.use_uber_shader);
+    ui->toggle_texture_deduplication->setChecked(Settings::values.use_texture_deduplication);
     ui->toggle_shader_jit->setChecked(Settings::values.use_shader_jit);
     ui->resolution_factor_combobox->setCurrentIndex(Settings::values.resolution_factor);
     ui->toggle_vsync->setChecked(Settings::values.use_vsync);
@@ -79,6 +84,11 @@ void ConfigureGraphics::applyConfiguration() {
     Settings::values.use_hw_shader = ui->toggle_hw_shader->isChecked();
     Settings::values.shaders_accurate_gs = ui->toggle_accurate_gs->isChecked();
     Settings::values.shaders_accurate_mul = ui->toggle_accurate_mul->isChecked();
+    Settings::values.use_disk_shader_cache = ui->toggle_disk_shader_cache->isChecked();
+    Settings::values.use_async_shader_compilation =
+        ui->toggle_async_shader_compilation->isChecked();
+    Settings::values.use_uber_shader = ui->toggle_uber_shader->isChecked();
+    Settings::values.use_texture_deduplication = ui->toggle_texture_deduplication->isChecked();
     Settings::values.use_shader_jit = ui->toggle_shader_jit->isChecked();
     Settings::values.resolution_factor =
         static_cast<u16>(ui->resolution_factor_combobox->currentIndex());
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <QApplication>
 #include <QFileInfo>
 #include <QFileSystemWatcher>
@@ -32,6 +33,7 @@
 #include "core/file_sys/archive_extsavedata.h"
 #include "core/file_sys/archive_source_sd_savedata.h"
 #include "core/hle/service/fs/archive.h"
+#include "core/settings.h"
 
 GameListSearchField::KeyReleaseEater::KeyReleaseEater(GameList* gamelist) : gamelist{gamelist} {}
 
@@ -454,6 +456,7 @@ void GameList::AddGamePopup(QMenu& context_menu, const QString& path, u64 progra
     QAction* open_application_location = context_menu.addAction(tr("Open Application Location"));
     QAction* open_update_location = context_menu.addAction(tr("Open Update Data Location"));
     QAction* navigate_to_gamedb_entry = context_menu.addAction(tr("Navigate to GameDB entry"));
+    QAction* use_uber_shader = context_menu.addAction(tr("Use Uber Shader"));
 
     const bool is_application =
         0x0004000000000000 <= program_id && program_id <= 0x00040000FFFFFFFF;
@@ -481,6 +484,12 @@ void GameList::AddGamePopup(QMenu& context_menu, const QString& path, u64 progra
     auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
     navigate_to_gamedb_entry->setVisible(it != compatibility_list.end());
 
+    const auto& uber_shader_titles = Settings::values.uber_shader_titles;
+    use_uber_shader->setCheckable(true);
+    use_uber_shader->setChecked(std::find(uber_shader_titles.begin(), uber_shader_titles.end(),
+                                          program_id) != uber_shader_titles.end());
+    use_uber_shader->setVisible(program_id != 0);
+
     connect(open_save_location, &QAction::triggered, [this, program_id] {
         emit OpenFolderRequested(program_id, GameListOpenTarget::SAVE_DATA);
     });
@@ -496,6 +505,15 @@ void GameList::AddGamePopup(QMenu& context_menu, const QString& path, u64 progra
     connect(navigate_to_gamedb_entry, &QAction::triggered, [this, program_id]() {
         emit NavigateToGamedbEntryRequested(program_id, compatibility_list);
     });
+    connect(use_uber_shader, &QAction::triggered, [program_id](bool checked) {
+        // Takes effect the next time the title is started
+        auto& titles = Settings::values.uber_shader_titles;
+        if (checked) {
+            titles.push_back(program_id);
+        } else {
+            titles.erase(std::remove(titles.begin(), titles.end(), program_id), titles.end());
+        }
+    });
 };
 
 void GameList::AddCustomDirPopup(QMenu& context_menu, QModelIndex selected) {
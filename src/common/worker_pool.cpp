@@ -0,0 +1,81 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include "common/thread.h"
+#include "common/worker_pool.h"
+
+namespace Common {
+
+WorkerPool::WorkerPool(std::string name_, unsigned num_workers) : name(std::move(name_)) {
+    for (unsigned i = 0; i < num_workers; ++i) {
+        workers.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    work_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::ParallelFor(std::size_t count, std::function<void(std::size_t)> task_) {
+    std::lock_guard<std::mutex> call_lock(call_mutex);
+    if (workers.empty() || count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task_(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = std::move(task_);
+        task_count = count;
+        next_index = 0;
+        busy_workers = workers.size();
+        ++generation;
+    }
+    work_available.notify_all();
+
+    RunTasks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    work_done.wait(lock, [this] { return busy_workers == 0; });
+}
+
+void WorkerPool::WorkerLoop() {
+    SetCurrentThreadName(name.c_str());
+    u64 last_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            work_available.wait(lock, [&] { return stop || generation != last_generation; });
+            if (stop)
+                return;
+            last_generation = generation;
+        }
+
+        RunTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busy_workers;
+        }
+        work_done.notify_one();
+    }
+}
+
+void WorkerPool::RunTasks() {
+    for (std::size_t i = next_index++; i < task_count; i = next_index++) {
+        task(i);
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,64 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * A small pool of threads used to split up work that takes a fraction of a millisecond, such as
+ * the sources of an audio frame or the rows of a large image. The threads are kept alive between
+ * calls, as starting a thread costs about as much as the work itself.
+ */
+class WorkerPool final {
+public:
+    /**
+     * @param name Name given to the worker threads
+     * @param num_workers Number of threads to start, in addition to the thread calling ParallelFor
+     */
+    WorkerPool(std::string name, unsigned num_workers);
+    ~WorkerPool();
+
+    /// Returns the number of threads running tasks, including the thread calling ParallelFor
+    unsigned NumThreads() const {
+        return static_cast<unsigned>(workers.size()) + 1;
+    }
+
+    /// Calls task for every index in [0, count) on the pool and the caller thread, returning once
+    /// all calls have finished. Calls from several threads are run one after another.
+    void ParallelFor(std::size_t count, std::function<void(std::size_t)> task);
+
+private:
+    void WorkerLoop();
+    void RunTasks();
+
+    std::string name;
+    std::vector<std::thread> workers;
+
+    /// Serializes callers of ParallelFor
+    std::mutex call_mutex;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    u64 generation = 0;
+    std::size_t busy_workers = 0;
+    bool stop = false;
+
+    std::function<void(std::size_t)> task;
+    std::size_t task_count = 0;
+    std::atomic<std::size_t> next_index{0};
+};
+
+} // namespace Common
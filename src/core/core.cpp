@@ -252,6 +252,19 @@ void System::Shutdown() {
                          perf_results.game_fps);
     Telemetry().AddField(Telemetry::FieldType::Performance, "Shutdown_Frametime",
                          perf_results.frametime * 1000.0);
+    Telemetry().AddField(Telemetry::FieldType::Performance, "Shutdown_PresentLatency",
+                         perf_results.present_latency * 1000.0);
+    Telemetry().AddField(Telemetry::FieldType::Performance, "Shutdown_DroppedFrames",
+                         perf_results.dropped_frames);
+    if (dsp_core) {
+        const auto output_stats = dsp_core->GetAndResetOutputStats();
+        Telemetry().AddField(Telemetry::FieldType::Performance, "Shutdown_AudioQueueLength",
+                             output_stats.queue_length * 1000.0);
+        Telemetry().AddField(Telemetry::FieldType::Performance, "Shutdown_AudioUnderruns",
+                             output_stats.underruns);
+        Telemetry().AddField(Telemetry::FieldType::Performance, "Shutdown_AudioStretchRatio",
+                             output_stats.stretch_ratio);
+    }
 
     // Shutdown emulation session
     GDBStub::Shutdown();
@@ -55,6 +55,14 @@ public:
         return delay_generator->GetReadDelayNs(length);
     }
 
+    /**
+     * Whether Read may be called from another thread while the file is in use, which allows the
+     * host read to be done in the background
+     */
+    virtual bool AllowsConcurrentReads() const {
+        return false;
+    }
+
     /**
      * Get the size of the file in bytes
      * @return Size of the file in bytes
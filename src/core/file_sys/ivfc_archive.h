@@ -95,6 +95,9 @@ public:
     ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override;
     ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
                                  const u8* buffer) override;
+    bool AllowsConcurrentReads() const override {
+        return true;
+    }
     u64 GetSize() const override;
     bool SetSize(u64 size) const override;
     bool Close() const override {
@@ -1,17 +1,74 @@
 #include <algorithm>
+#include <cstring>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include "core/file_sys/romfs_reader.h"
 
 namespace FileSys {
 
+RomFSReader::~RomFSReader() {
+    if (readahead_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(readahead_mutex);
+            readahead_stop = true;
+        }
+        readahead_cv.notify_one();
+        readahead_thread.join();
+    }
+}
+
 std::size_t RomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
-    if (length == 0)
-        return 0; // Crypto++ does not like zero size buffer
-    file.Seek(file_offset + offset, SEEK_SET);
-    std::size_t read_length = std::min(length, data_size - offset);
-    read_length = file.ReadBytes(buffer, read_length);
-    if (is_encrypted) {
+    if (length == 0 || offset >= data_size)
+        return 0;
+    const std::size_t read_length = std::min(length, data_size - offset);
+
+    if (!is_encrypted) {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        file.Seek(file_offset + offset, SEEK_SET);
+        return file.ReadBytes(buffer, read_length);
+    }
+
+    if (read_length >= DIRECT_READ_SIZE) {
+        // Large reads would only evict the blocks of small reads from the cache
+        return ReadDecrypted(offset, read_length, buffer);
+    }
+
+    std::size_t done = 0;
+    while (done < read_length) {
+        const std::size_t position = offset + done;
+        const Block block = GetBlock(position / BLOCK_SIZE);
+        const std::size_t block_offset = position % BLOCK_SIZE;
+        if (block_offset >= block->size())
+            break; // The file is shorter than the RomFS
+
+        const std::size_t copy_length = std::min(read_length - done, block->size() - block_offset);
+        std::memcpy(buffer + done, block->data() + block_offset, copy_length);
+        done += copy_length;
+    }
+
+    // Applications usually stream assets in consecutive reads, so the following block is
+    // likely to be needed next
+    const std::size_t read_end = offset + done;
+    if (last_read_end.exchange(read_end) == offset && read_end < data_size) {
+        const std::size_t next_block = (read_end + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        if (next_block * BLOCK_SIZE < data_size && !FindBlock(next_block)) {
+            Prefetch(next_block);
+        }
+    }
+
+    return done;
+}
+
+std::size_t RomFSReader::ReadDecrypted(std::size_t offset, std::size_t length, u8* buffer) {
+    std::size_t read_length;
+    {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        file.Seek(file_offset + offset, SEEK_SET);
+        read_length = file.ReadBytes(buffer, length);
+    }
+
+    // Crypto++ does not like zero size buffer
+    if (read_length != 0) {
         CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
         d.Seek(crypto_offset + offset);
         d.ProcessData(buffer, buffer, read_length);
@@ -19,4 +76,72 @@ std::size_t RomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* bu
     return read_length;
 }
 
+RomFSReader::Block RomFSReader::GetBlock(std::size_t index) {
+    if (Block block = FindBlock(index))
+        return block;
+
+    const std::size_t offset = index * BLOCK_SIZE;
+    std::vector<u8> data(std::min(BLOCK_SIZE, data_size - offset));
+    data.resize(ReadDecrypted(offset, data.size(), data.data()));
+
+    auto block = std::make_shared<const std::vector<u8>>(std::move(data));
+    InsertBlock(index, block);
+    return block;
+}
+
+RomFSReader::Block RomFSReader::FindBlock(std::size_t index) {
+    CacheShard& shard = cache_shards[index % NUM_CACHE_SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.map.find(index);
+    if (it == shard.map.end())
+        return nullptr;
+
+    shard.blocks.splice(shard.blocks.begin(), shard.blocks, it->second);
+    return it->second->second;
+}
+
+void RomFSReader::InsertBlock(std::size_t index, Block block) {
+    CacheShard& shard = cache_shards[index % NUM_CACHE_SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.map.count(index) != 0)
+        return; // Another thread read the same block in the meantime
+
+    shard.blocks.emplace_front(index, std::move(block));
+    shard.map.emplace(index, shard.blocks.begin());
+    if (shard.blocks.size() > BLOCKS_PER_SHARD) {
+        shard.map.erase(shard.blocks.back().first);
+        shard.blocks.pop_back();
+    }
+}
+
+void RomFSReader::Prefetch(std::size_t index) {
+    {
+        std::lock_guard<std::mutex> lock(readahead_mutex);
+        if (std::find(readahead_requests.begin(), readahead_requests.end(), index) !=
+            readahead_requests.end()) {
+            return;
+        }
+        readahead_requests.push_back(index);
+        if (!readahead_thread.joinable()) {
+            readahead_thread = std::thread(&RomFSReader::ReadaheadLoop, this);
+        }
+    }
+    readahead_cv.notify_one();
+}
+
+void RomFSReader::ReadaheadLoop() {
+    std::unique_lock<std::mutex> lock(readahead_mutex);
+    while (true) {
+        readahead_cv.wait(lock, [this] { return readahead_stop || !readahead_requests.empty(); });
+        if (readahead_stop)
+            return;
+
+        const std::size_t index = readahead_requests.front();
+        lock.unlock();
+        GetBlock(index);
+        lock.lock();
+        readahead_requests.erase(readahead_requests.begin());
+    }
+}
+
 } // namespace FileSys
@@ -1,11 +1,26 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "common/common_types.h"
 #include "common/file_util.h"
 
 namespace FileSys {
 
+/**
+ * Reads the RomFS of an NCCH. Encrypted RomFS is decrypted in blocks which are kept in a cache,
+ * so that the many small reads applications do only decrypt each block once, and the block after
+ * a sequential read is decrypted ahead of time on a separate thread. Reads may be done from
+ * several threads at once.
+ */
 class RomFSReader {
 public:
     RomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size)
@@ -18,6 +33,8 @@ public:
         : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
           crypto_offset(crypto_offset), data_size(data_size) {}
 
+    ~RomFSReader();
+
     std::size_t GetSize() const {
         return data_size;
     }
@@ -25,6 +42,36 @@ public:
     std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer);
 
 private:
+    /// Size of the blocks encrypted data is decrypted and cached in
+    static constexpr std::size_t BLOCK_SIZE = 0x10000;
+    /// The cache is split into shards with separate locks, so that parallel reads rarely contend
+    static constexpr std::size_t NUM_CACHE_SHARDS = 4;
+    static constexpr std::size_t BLOCKS_PER_SHARD = 16;
+    /// Reads of at least this size are decrypted into the destination without using the cache
+    static constexpr std::size_t DIRECT_READ_SIZE = 0x100000;
+
+    using Block = std::shared_ptr<const std::vector<u8>>;
+
+    struct CacheShard {
+        std::mutex mutex;
+        /// Cached blocks ordered from the most to the least recently used
+        std::list<std::pair<std::size_t, Block>> blocks;
+        std::unordered_map<std::size_t, std::list<std::pair<std::size_t, Block>>::iterator> map;
+    };
+
+    /// Reads and decrypts length bytes at offset into buffer
+    std::size_t ReadDecrypted(std::size_t offset, std::size_t length, u8* buffer);
+
+    /// Returns a cached block, reading it if it is not cached
+    Block GetBlock(std::size_t index);
+    /// Returns a cached block, or nullptr if it is not cached
+    Block FindBlock(std::size_t index);
+    void InsertBlock(std::size_t index, Block block);
+
+    /// Requests the readahead thread to cache a block
+    void Prefetch(std::size_t index);
+    void ReadaheadLoop();
+
     bool is_encrypted;
     FileUtil::IOFile file;
     std::array<u8, 16> key;
@@ -32,6 +79,20 @@ private:
     std::size_t file_offset;
     std::size_t crypto_offset;
     std::size_t data_size;
+
+    /// Serializes the accesses to the file
+    std::mutex file_mutex;
+
+    std::array<CacheShard, NUM_CACHE_SHARDS> cache_shards;
+
+    /// Offset following the last read, used to detect sequential reads
+    std::atomic<std::size_t> last_read_end{0};
+
+    std::thread readahead_thread;
+    std::mutex readahead_mutex;
+    std::condition_variable readahead_cv;
+    std::vector<std::size_t> readahead_requests;
+    bool readahead_stop = false;
 };
 
 } // namespace FileSys
@@ -10,6 +10,21 @@
 #include "common/common_types.h"
 #include "core/frontend/framebuffer_layout.h"
 
+/**
+ * A graphics context sharing its objects with the context of an EmuWindow, which can be used on a
+ * different thread than the window context.
+ */
+class GraphicsContext {
+public:
+    virtual ~GraphicsContext() = default;
+
+    /// Makes the graphics context current for the caller thread
+    virtual void MakeCurrent() = 0;
+
+    /// Releases the graphics context from the caller thread
+    virtual void DoneCurrent() = 0;
+};
+
 /**
  * Abstraction class used to provide an interface between emulation code and the frontend
  * (e.g. SDL, QGLWidget, GLFW, etc...).
@@ -50,6 +65,16 @@ public:
     /// Releases (dunno if this is the "right" word) the GLFW context from the caller thread
     virtual void DoneCurrent() = 0;
 
+    /**
+     * Creates a context sharing its objects with the window context. The window context must be
+     * current on the caller thread, and the new context is current afterwards. This allows the
+     * window context to be used for presenting frames on another thread.
+     * @returns nullptr if the frontend does not support shared contexts
+     */
+    virtual std::unique_ptr<GraphicsContext> CreateSharedContext() const {
+        return nullptr;
+    }
+
     /**
      * Signal that a touch pressed event has occurred (e.g. mouse click pressed)
      * @param framebuffer_x Framebuffer x-coordinate that was pressed
@@ -348,8 +348,29 @@ void ArchiveManager::RegisterSelfNCCH(Loader::AppLoader& app_loader) {
     factory->Register(app_loader);
 }
 
+void ArchiveManager::RunOnIOThread(std::function<void()> task) {
+    if (!io_thread.joinable()) {
+        io_thread = std::thread([this] {
+            while (true) {
+                const std::function<void()> next_task = io_tasks.PopWait();
+                if (!next_task)
+                    break;
+                next_task();
+            }
+        });
+    }
+    io_tasks.Push(std::move(task));
+}
+
 ArchiveManager::ArchiveManager(Core::System& system) : system(system) {
     RegisterArchiveTypes();
 }
 
+ArchiveManager::~ArchiveManager() {
+    if (io_thread.joinable()) {
+        io_tasks.Push(std::function<void()>{});
+        io_thread.join();
+    }
+}
+
 } // namespace Service::FS
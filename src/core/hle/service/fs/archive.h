@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include <boost/container/flat_map.hpp>
 #include "common/common_types.h"
+#include "common/threadsafe_queue.h"
 #include "core/file_sys/archive_backend.h"
 #include "core/hle/result.h"
 #include "core/hle/service/fs/directory.h"
@@ -55,6 +58,7 @@ using FileSys::ArchiveFactory;
 class ArchiveManager {
 public:
     explicit ArchiveManager(Core::System& system);
+    ~ArchiveManager();
 
     /**
      * Opens an archive
@@ -228,6 +232,12 @@ public:
     /// Registers a new NCCH file with the SelfNCCH archive factory
     void RegisterSelfNCCH(Loader::AppLoader& app_loader);
 
+    /**
+     * Runs a task on the I/O thread, which reads files on the host while the guest threads that
+     * requested the reads wait for their emulated delays
+     */
+    void RunOnIOThread(std::function<void()> task);
+
 private:
     Core::System& system;
 
@@ -255,6 +265,10 @@ private:
      */
     std::unordered_map<ArchiveHandle, std::unique_ptr<ArchiveBackend>> handle_map;
     ArchiveHandle next_handle = 1;
+
+    /// Tasks for the I/O thread, an empty task stops it. Only the emulation thread adds tasks.
+    Common::SPSCQueue<std::function<void()>> io_tasks;
+    std::thread io_thread;
 };
 
 } // namespace Service::FS
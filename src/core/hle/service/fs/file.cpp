@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <future>
+#include <memory>
+#include <vector>
 #include "common/logging/log.h"
 #include "core/core.h"
 #include "core/file_sys/errors.h"
@@ -11,6 +14,7 @@
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/service/fs/archive.h"
 #include "core/hle/service/fs/file.h"
 
 namespace Service::FS {
@@ -56,6 +60,42 @@ void File::Read(Kernel::HLERequestContext& ctx) {
                   offset, length, backend->GetSize());
     }
 
+    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
+
+    if (backend->AllowsConcurrentReads() && read_timeout_ns.count() > 0) {
+        // Read on the I/O thread while the guest thread waits for the emulated delay, so that a
+        // slow host disk only stalls emulation if the read takes longer than the delay
+        auto data = std::make_shared<std::vector<u8>>(length);
+        auto task = std::make_shared<std::packaged_task<ResultVal<std::size_t>()>>(
+            [backend = backend, offset, data] {
+                return backend->Read(offset, data->size(), data->data());
+            });
+        std::shared_future<ResultVal<std::size_t>> result = task->get_future().share();
+        system.ArchiveManager().RunOnIOThread([task] { (*task)(); });
+
+        const u32 buffer_id = buffer.GetId();
+        ctx.SleepClientThread(
+            system.Kernel().GetThreadManager().GetCurrentThread(), "file::read", read_timeout_ns,
+            [data, result, buffer_id](Kernel::SharedPtr<Kernel::Thread> thread,
+                                      Kernel::HLERequestContext& ctx,
+                                      Kernel::ThreadWakeupReason reason) {
+                // Waits for the host read if it is still running
+                const ResultVal<std::size_t>& read = result.get();
+                auto& buffer = ctx.GetMappedBuffer(buffer_id);
+                IPC::RequestBuilder rb(ctx, 0x0802, 2, 2);
+                if (read.Failed()) {
+                    rb.Push(read.Code());
+                    rb.Push<u32>(0);
+                } else {
+                    buffer.Write(data->data(), 0, *read);
+                    rb.Push(RESULT_SUCCESS);
+                    rb.Push<u32>(static_cast<u32>(*read));
+                }
+                rb.PushMappedBuffer(buffer);
+            });
+        return;
+    }
+
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
 
     std::vector<u8> data(length);
@@ -70,7 +110,6 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     }
     rb.PushMappedBuffer(buffer);
 
-    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
     ctx.SleepClientThread(system.Kernel().GetThreadManager().GetCurrentThread(), "file::read",
                           read_timeout_ns,
                           [](Kernel::SharedPtr<Kernel::Thread> thread,
@@ -34,7 +34,8 @@ public:
     }
 
     FileSys::Path path;                            ///< Path of the file
-    std::unique_ptr<FileSys::FileBackend> backend; ///< File backend interface
+    /// File backend interface, shared with reads running on the I/O thread
+    std::shared_ptr<FileSys::FileBackend> backend;
 
     /// Creates a new session to this File and returns the ClientSession part of the connection.
     Kernel::SharedPtr<Kernel::ClientSession> Connect();
@@ -2,15 +2,20 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <numeric>
+#include <thread>
 #include <type_traits>
+#include <vector>
 #include "common/alignment.h"
 #include "common/color.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/vector_math.h"
+#include "common/worker_pool.h"
 #include "core/core_timing.h"
 #include "core/hle/service/gsp/gsp.h"
 #include "core/hw/gpu.h"
@@ -73,6 +78,36 @@ static Math::Vec4<u8> DecodePixel(Regs::PixelFormat input_format, const u8* src_
 MICROPROFILE_DEFINE(GPU_DisplayTransfer, "GPU", "DisplayTransfer", MP_RGB(100, 100, 255));
 MICROPROFILE_DEFINE(GPU_CmdlistProcessing, "GPU", "Cmdlist Processing", MP_RGB(100, 255, 100));
 
+/// Display transfers with at least this many output pixels are split across multiple threads
+constexpr u32 DISPLAY_TRANSFER_PARALLEL_THRESHOLD = 256 * 256;
+/// Maximum number of threads a single display transfer is split across
+constexpr u32 DISPLAY_TRANSFER_MAX_THREADS = 4;
+
+/// Threads splitting up large display transfers, started on first use
+static Common::WorkerPool& GetTransferWorkers() {
+    static Common::WorkerPool workers(
+        "DisplayTransfer",
+        std::clamp(std::thread::hardware_concurrency(), 1u, DISPLAY_TRANSFER_MAX_THREADS) - 1);
+    return workers;
+}
+
+/**
+ * Fills size bytes at dst with a repeating pattern. Instead of storing one value at a time, the
+ * already filled part is copied over the rest, doubling the copy size every time.
+ */
+static void FillPattern(u8* dst, std::size_t size, const u8* pattern, std::size_t pattern_size) {
+    if (size == 0)
+        return;
+
+    std::size_t filled = std::min(pattern_size, size);
+    std::memcpy(dst, pattern, filled);
+    while (filled < size) {
+        const std::size_t copy_size = std::min(filled, size - filled);
+        std::memcpy(dst + filled, dst, copy_size);
+        filled += copy_size;
+    }
+}
+
 static void MemoryFill(const Regs::MemoryFillConfig& config) {
     const PAddr start_addr = config.GetStartAddress();
     const PAddr end_addr = config.GetEndAddress();
@@ -105,24 +140,23 @@ static void MemoryFill(const Regs::MemoryFillConfig& config) {
 
     if (config.fill_24bit) {
         // fill with 24-bit values
-        for (u8* ptr = start; ptr < end; ptr += 3) {
-            ptr[0] = config.value_24bit_r;
-            ptr[1] = config.value_24bit_g;
-            ptr[2] = config.value_24bit_b;
-        }
+        const std::array<u8, 3> value = {config.value_24bit_r, config.value_24bit_g,
+                                         config.value_24bit_b};
+        // The last value is written completely even if it crosses the end address
+        FillPattern(start, Common::AlignUp<std::size_t>(end - start, 3), value.data(), 3);
     } else if (config.fill_32bit) {
         // fill with 32-bit values
         if (end > start) {
             u32 value = config.value_32bit;
             std::size_t len = (end - start) / sizeof(u32);
-            for (std::size_t i = 0; i < len; ++i)
-                memcpy(&start[i * sizeof(u32)], &value, sizeof(u32));
+            FillPattern(start, len * sizeof(u32), reinterpret_cast<const u8*>(&value),
+                        sizeof(u32));
         }
     } else {
         // fill with 16-bit values
         u16 value_16bit = config.value_16bit.Value();
-        for (u8* ptr = start; ptr < end; ptr += sizeof(u16))
-            memcpy(ptr, &value_16bit, sizeof(u16));
+        FillPattern(start, Common::AlignUp<std::size_t>(end - start, sizeof(u16)),
+                    reinterpret_cast<const u8*>(&value_16bit), sizeof(u16));
     }
 }
 
@@ -193,112 +227,146 @@ static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
     Memory::RasterizerFlushRegion(config.GetPhysicalInputAddress(), input_size);
     Memory::RasterizerInvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
 
-    for (u32 y = 0; y < output_height; ++y) {
-        for (u32 x = 0; x < output_width; ++x) {
-            Math::Vec4<u8> src_color;
-
-            // Calculate the [x,y] position of the input image
-            // based on the current output position and the scale
-            u32 input_x = x << horizontal_scale;
-            u32 input_y = y << vertical_scale;
-
-            u32 output_y;
-            if (config.flip_vertically) {
-                // Flip the y value of the output data,
-                // we do this after calculating the [x,y] position of the input image
-                // to account for the scaling options.
-                output_y = output_height - y - 1;
-            } else {
-                output_y = y;
-            }
-
-            u32 dst_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.output_format);
-            u32 src_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.input_format);
-            u32 src_offset;
-            u32 dst_offset;
-
-            if (config.input_linear) {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as linear and the output as tiled
-                    u32 coarse_y = output_y & ~7;
-                    u32 stride = output_width * dst_bytes_per_pixel;
-
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 coarse_y * stride;
+    const u32 dst_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.output_format);
+    const u32 src_bytes_per_pixel = GPU::Regs::BytesPerPixel(config.input_format);
+
+    // Converting between identical formats without scaling leaves the pixel data unchanged
+    const bool copy_pixels =
+        config.input_format == config.output_format && config.scaling == config.NoScale;
+
+    // Every output row is written independently of the others
+    auto transfer_rows = [&](u32 first_y, u32 last_y) {
+        for (u32 y = first_y; y < last_y; ++y) {
+            for (u32 x = 0; x < output_width; ++x) {
+                Math::Vec4<u8> src_color;
+
+                // Calculate the [x,y] position of the input image
+                // based on the current output position and the scale
+                u32 input_x = x << horizontal_scale;
+                u32 input_y = y << vertical_scale;
+
+                u32 output_y;
+                if (config.flip_vertically) {
+                    // Flip the y value of the output data,
+                    // we do this after calculating the [x,y] position of the input image
+                    // to account for the scaling options.
+                    output_y = output_height - y - 1;
                 } else {
-                    // Both input and output are linear
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
+                    output_y = y;
                 }
-            } else {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as tiled and the output as linear
-                    u32 coarse_y = input_y & ~7;
-                    u32 stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 coarse_y * stride;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                } else {
-                    // Both input and output are tiled
-                    u32 out_coarse_y = output_y & ~7;
-                    u32 out_stride = output_width * dst_bytes_per_pixel;
 
-                    u32 in_coarse_y = input_y & ~7;
-                    u32 in_stride = config.input_width * src_bytes_per_pixel;
+                u32 src_offset;
+                u32 dst_offset;
+
+                if (config.input_linear) {
+                    if (!config.dont_swizzle) {
+                        // Interpret the input as linear and the output as tiled
+                        u32 coarse_y = output_y & ~7;
+                        u32 stride = output_width * dst_bytes_per_pixel;
+
+                        src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
+                        dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
+                                     coarse_y * stride;
+                    } else {
+                        // Both input and output are linear
+                        src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
+                        dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
+                    }
+                } else {
+                    if (!config.dont_swizzle) {
+                        // Interpret the input as tiled and the output as linear
+                        u32 coarse_y = input_y & ~7;
+                        u32 stride = config.input_width * src_bytes_per_pixel;
+
+                        src_offset =
+                            VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
+                            coarse_y * stride;
+                        dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
+                    } else {
+                        // Both input and output are tiled
+                        u32 out_coarse_y = output_y & ~7;
+                        u32 out_stride = output_width * dst_bytes_per_pixel;
+
+                        u32 in_coarse_y = input_y & ~7;
+                        u32 in_stride = config.input_width * src_bytes_per_pixel;
+
+                        src_offset =
+                            VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
+                            in_coarse_y * in_stride;
+                        dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
+                                     out_coarse_y * out_stride;
+                    }
+                }
 
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 in_coarse_y * in_stride;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 out_coarse_y * out_stride;
+                const u8* src_pixel = src_pointer + src_offset;
+                u8* dst_pixel = dst_pointer + dst_offset;
+                if (copy_pixels) {
+                    std::memcpy(dst_pixel, src_pixel, dst_bytes_per_pixel);
+                    continue;
                 }
-            }
 
-            const u8* src_pixel = src_pointer + src_offset;
-            src_color = DecodePixel(config.input_format, src_pixel);
-            if (config.scaling == config.ScaleX) {
-                Math::Vec4<u8> pixel =
-                    DecodePixel(config.input_format, src_pixel + src_bytes_per_pixel);
-                src_color = ((src_color + pixel) / 2).Cast<u8>();
-            } else if (config.scaling == config.ScaleXY) {
-                Math::Vec4<u8> pixel1 =
-                    DecodePixel(config.input_format, src_pixel + 1 * src_bytes_per_pixel);
-                Math::Vec4<u8> pixel2 =
-                    DecodePixel(config.input_format, src_pixel + 2 * src_bytes_per_pixel);
-                Math::Vec4<u8> pixel3 =
-                    DecodePixel(config.input_format, src_pixel + 3 * src_bytes_per_pixel);
-                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
-            }
+                src_color = DecodePixel(config.input_format, src_pixel);
+                if (config.scaling == config.ScaleX) {
+                    Math::Vec4<u8> pixel =
+                        DecodePixel(config.input_format, src_pixel + src_bytes_per_pixel);
+                    src_color = ((src_color + pixel) / 2).Cast<u8>();
+                } else if (config.scaling == config.ScaleXY) {
+                    Math::Vec4<u8> pixel1 =
+                        DecodePixel(config.input_format, src_pixel + 1 * src_bytes_per_pixel);
+                    Math::Vec4<u8> pixel2 =
+                        DecodePixel(config.input_format, src_pixel + 2 * src_bytes_per_pixel);
+                    Math::Vec4<u8> pixel3 =
+                        DecodePixel(config.input_format, src_pixel + 3 * src_bytes_per_pixel);
+                    src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
+                }
 
-            u8* dst_pixel = dst_pointer + dst_offset;
-            switch (config.output_format) {
-            case Regs::PixelFormat::RGBA8:
-                Color::EncodeRGBA8(src_color, dst_pixel);
-                break;
+                switch (config.output_format) {
+                case Regs::PixelFormat::RGBA8:
+                    Color::EncodeRGBA8(src_color, dst_pixel);
+                    break;
 
-            case Regs::PixelFormat::RGB8:
-                Color::EncodeRGB8(src_color, dst_pixel);
-                break;
+                case Regs::PixelFormat::RGB8:
+                    Color::EncodeRGB8(src_color, dst_pixel);
+                    break;
 
-            case Regs::PixelFormat::RGB565:
-                Color::EncodeRGB565(src_color, dst_pixel);
-                break;
+                case Regs::PixelFormat::RGB565:
+                    Color::EncodeRGB565(src_color, dst_pixel);
+                    break;
 
-            case Regs::PixelFormat::RGB5A1:
-                Color::EncodeRGB5A1(src_color, dst_pixel);
-                break;
+                case Regs::PixelFormat::RGB5A1:
+                    Color::EncodeRGB5A1(src_color, dst_pixel);
+                    break;
 
-            case Regs::PixelFormat::RGBA4:
-                Color::EncodeRGBA4(src_color, dst_pixel);
-                break;
+                case Regs::PixelFormat::RGBA4:
+                    Color::EncodeRGBA4(src_color, dst_pixel);
+                    break;
 
-            default:
-                LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
-                          static_cast<u32>(config.output_format.Value()));
-                break;
+                default:
+                    LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
+                              static_cast<u32>(config.output_format.Value()));
+                    break;
+                }
             }
         }
+    };
+
+    // Rows of an in-place or overlapping transfer depend on the order in which they are written
+    const bool regions_overlap =
+        src_addr < dst_addr + output_size && dst_addr < src_addr + input_size;
+
+    if (regions_overlap || output_width * output_height < DISPLAY_TRANSFER_PARALLEL_THRESHOLD) {
+        transfer_rows(0, output_height);
+    } else {
+        // Split at tile row boundaries so that tiled output rows of one tile stay together
+        Common::WorkerPool& workers = GetTransferWorkers();
+        const u32 num_threads = workers.NumThreads();
+        const u32 rows_per_thread =
+            Common::AlignUp((output_height + num_threads - 1) / num_threads, 8u);
+        const u32 num_chunks = (output_height + rows_per_thread - 1) / rows_per_thread;
+        workers.ParallelFor(num_chunks, [&](std::size_t chunk) {
+            const u32 first_y = static_cast<u32>(chunk) * rows_per_thread;
+            transfer_rows(first_y, std::min(first_y + rows_per_thread, output_height));
+        });
     }
 }
 
@@ -6,6 +6,8 @@
 #include <chrono>
 #include <mutex>
 #include <thread>
+#include "audio_core/dsp_interface.h"
+#include "core/core.h"
 #include "core/hw/gpu.h"
 #include "core/perf_stats.h"
 #include "core/settings.h"
@@ -40,6 +42,19 @@ void PerfStats::EndGameFrame() {
     game_frames += 1;
 }
 
+void PerfStats::FramePresented(Clock::duration latency) {
+    std::lock_guard<std::mutex> lock(object_mutex);
+
+    accumulated_present_latency += latency;
+    presented_frames += 1;
+}
+
+void PerfStats::FrameDropped() {
+    std::lock_guard<std::mutex> lock(object_mutex);
+
+    dropped_frames += 1;
+}
+
 PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us) {
     std::lock_guard<std::mutex> lock(object_mutex);
 
@@ -55,6 +70,11 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     results.frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second.count() / 1'000'000.0;
+    if (presented_frames != 0) {
+        results.present_latency = duration_cast<DoubleSecs>(accumulated_present_latency).count() /
+                                  static_cast<double>(presented_frames);
+    }
+    results.dropped_frames = dropped_frames;
 
     // Reset counters
     reset_point = now;
@@ -62,6 +82,9 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
+    accumulated_present_latency = Clock::duration::zero();
+    presented_frames = 0;
+    dropped_frames = 0;
 
     return results;
 }
@@ -86,6 +109,15 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
     }
 
     auto now = Clock::now();
+
+    if (Core::DSP().IsPacingEmulation()) {
+        // The audio output already blocks emulation to keep it in sync, keep the limiter state
+        // current so that it resumes smoothly if the sink stops requesting samples
+        frame_limiting_delta_err = microseconds::zero();
+        previous_system_time_us = current_system_time_us;
+        previous_walltime = now;
+        return;
+    }
     double sleep_scale = Settings::values.frame_limit / 100.0;
 
     // Max lag caused by slow frames. Shouldn't be more than the length of a frame at the current
@@ -29,12 +29,21 @@ public:
         double frametime;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Average walltime from the submission of a frame to its presentation, in seconds
+        double present_latency;
+        /// Number of frames replaced by a newer frame before they were presented
+        u32 dropped_frames;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
+    /// Records that a frame was presented the given duration after the renderer submitted it
+    void FramePresented(Clock::duration latency);
+    /// Records that a submitted frame was replaced before it could be presented
+    void FrameDropped();
+
     Results GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
     /**
@@ -57,6 +66,12 @@ private:
     u32 system_frames = 0;
     /// Cumulative number of game frames (GSP frame submissions) since last reset
     u32 game_frames = 0;
+    /// Cumulative latency of the frames presented since last reset
+    Clock::duration accumulated_present_latency = Clock::duration::zero();
+    /// Cumulative number of frames presented since last reset
+    u32 presented_frames = 0;
+    /// Cumulative number of frames dropped before presentation since last reset
+    u32 dropped_frames = 0;
 
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end = reset_point;
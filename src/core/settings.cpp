@@ -70,6 +70,11 @@ void LogSettings() {
     LogSetting("Renderer_UseHwShader", Settings::values.use_hw_shader);
     LogSetting("Renderer_ShadersAccurateGs", Settings::values.shaders_accurate_gs);
     LogSetting("Renderer_ShadersAccurateMul", Settings::values.shaders_accurate_mul);
+    LogSetting("Renderer_UseDiskShaderCache", Settings::values.use_disk_shader_cache);
+    LogSetting("Renderer_UseAsyncShaderCompilation",
+               Settings::values.use_async_shader_compilation);
+    LogSetting("Renderer_UseUberShader", Settings::values.use_uber_shader);
+    LogSetting("Renderer_UseTextureDeduplication", Settings::values.use_texture_deduplication);
     LogSetting("Renderer_UseShaderJit", Settings::values.use_shader_jit);
     LogSetting("Renderer_UseResolutionFactor", Settings::values.resolution_factor);
     LogSetting("Renderer_UseVsync", Settings::values.use_vsync);
@@ -81,6 +86,11 @@ void LogSettings() {
     LogSetting("Layout_SwapScreen", Settings::values.swap_screen);
     LogSetting("Audio_OutputEngine", Settings::values.sink_id);
     LogSetting("Audio_EnableAudioStretching", Settings::values.enable_audio_stretching);
+    LogSetting("Audio_TimeStretchAlgorithm",
+               static_cast<int>(Settings::values.time_stretch_algorithm));
+    LogSetting("Audio_EnableDspMultithreading", Settings::values.enable_dsp_multithreading);
+    LogSetting("Audio_EnableAudioPacing", Settings::values.enable_audio_pacing);
+    LogSetting("Audio_Latency", Settings::values.audio_latency);
     LogSetting("Audio_OutputDevice", Settings::values.audio_device_id);
     using namespace Service::CAM;
     LogSetting("Camera_OuterRightName", Settings::values.camera_name[OuterRightCamera]);
@@ -7,6 +7,7 @@
 #include <array>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "common/common_types.h"
 #include "core/hle/service/cam/cam.h"
 
@@ -24,6 +25,11 @@ enum class LayoutOption {
     SideScreen,
 };
 
+enum class TimeStretchAlgorithm {
+    SoundTouch,
+    WSOLA,
+};
+
 namespace NativeButton {
 enum Values {
     A,
@@ -121,6 +127,11 @@ struct Values {
     bool use_hw_shader;
     bool shaders_accurate_gs;
     bool shaders_accurate_mul;
+    bool use_disk_shader_cache;
+    bool use_async_shader_compilation;
+    bool use_uber_shader;
+    std::vector<u64> uber_shader_titles;
+    bool use_texture_deduplication;
     bool use_shader_jit;
     u16 resolution_factor;
     bool use_vsync;
@@ -149,6 +160,10 @@ struct Values {
     // Audio
     std::string sink_id;
     bool enable_audio_stretching;
+    TimeStretchAlgorithm time_stretch_algorithm;
+    bool enable_dsp_multithreading;
+    bool enable_audio_pacing;
+    u16 audio_latency;
     std::string audio_device_id;
     float volume;
 
@@ -165,6 +165,13 @@ TelemetrySession::TelemetrySession() {
     AddField(Telemetry::FieldType::UserConfig, "Audio_SinkId", Settings::values.sink_id);
     AddField(Telemetry::FieldType::UserConfig, "Audio_EnableAudioStretching",
              Settings::values.enable_audio_stretching);
+    AddField(Telemetry::FieldType::UserConfig, "Audio_TimeStretchAlgorithm",
+             static_cast<int>(Settings::values.time_stretch_algorithm));
+    AddField(Telemetry::FieldType::UserConfig, "Audio_EnableDspMultithreading",
+             Settings::values.enable_dsp_multithreading);
+    AddField(Telemetry::FieldType::UserConfig, "Audio_EnableAudioPacing",
+             Settings::values.enable_audio_pacing);
+    AddField(Telemetry::FieldType::UserConfig, "Audio_Latency", Settings::values.audio_latency);
     AddField(Telemetry::FieldType::UserConfig, "Core_UseCpuJit", Settings::values.use_cpu_jit);
     AddField(Telemetry::FieldType::UserConfig, "Renderer_ResolutionFactor",
              Settings::values.resolution_factor);
@@ -179,6 +186,14 @@ TelemetrySession::TelemetrySession() {
              Settings::values.shaders_accurate_gs);
     AddField(Telemetry::FieldType::UserConfig, "Renderer_ShadersAccurateMul",
              Settings::values.shaders_accurate_mul);
+    AddField(Telemetry::FieldType::UserConfig, "Renderer_UseDiskShaderCache",
+             Settings::values.use_disk_shader_cache);
+    AddField(Telemetry::FieldType::UserConfig, "Renderer_UseAsyncShaderCompilation",
+             Settings::values.use_async_shader_compilation);
+    AddField(Telemetry::FieldType::UserConfig, "Renderer_UseUberShader",
+             Settings::values.use_uber_shader);
+    AddField(Telemetry::FieldType::UserConfig, "Renderer_UseTextureDeduplication",
+             Settings::values.use_texture_deduplication);
     AddField(Telemetry::FieldType::UserConfig, "Renderer_UseShaderJit",
              Settings::values.use_shader_jit);
     AddField(Telemetry::FieldType::UserConfig, "Renderer_UseVsync", Settings::values.use_vsync);
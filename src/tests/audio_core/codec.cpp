@@ -0,0 +1,75 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/codec.h"
+
+using namespace AudioCore;
+
+TEST_CASE("DecodePCM16 appends to the output", "[audio_core]") {
+    const std::array<s16, 6> samples{{1, -2, 300, -400, 32767, -32768}};
+    std::array<u8, sizeof(samples)> data;
+    std::memcpy(data.data(), samples.data(), sizeof(samples));
+
+    StereoBuffer16 output{{{7, 8}}};
+
+    SECTION("mono") {
+        Codec::DecodePCM16(1, data.data(), samples.size(), output);
+        REQUIRE(output.size() == 1 + samples.size());
+        REQUIRE(output[0] == std::array<s16, 2>{{7, 8}});
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            REQUIRE(output[1 + i] == std::array<s16, 2>{{samples[i], samples[i]}});
+        }
+    }
+
+    SECTION("stereo") {
+        Codec::DecodePCM16(2, data.data(), samples.size() / 2, output);
+        REQUIRE(output.size() == 1 + samples.size() / 2);
+        REQUIRE(output[0] == std::array<s16, 2>{{7, 8}});
+        for (std::size_t i = 0; i < samples.size() / 2; ++i) {
+            REQUIRE(output[1 + i] == std::array<s16, 2>{{samples[i * 2], samples[i * 2 + 1]}});
+        }
+    }
+}
+
+TEST_CASE("DecodePCM8 converts to PCM16", "[audio_core]") {
+    const std::array<u8, 4> data{{0x00, 0x7F, 0x80, 0xFF}};
+    StereoBuffer16 output;
+
+    Codec::DecodePCM8(2, data.data(), 2, output);
+    REQUIRE(output.size() == 2);
+    REQUIRE(output[0] == std::array<s16, 2>{{0x0000, 0x7F00}});
+    REQUIRE(output[1] == std::array<s16, 2>{{-0x8000, -0x0100}});
+}
+
+TEST_CASE("DecodeADPCM pads odd lengths", "[audio_core]") {
+    // One frame with a scale of 1 and zero coefficients, decoding the nibbles as they are
+    const std::array<u8, 8> data{{0x00, 0x12, 0x34, 0xF0, 0x00, 0x00, 0x00, 0x00}};
+    const std::array<s16, 16> coeffs{};
+    Codec::ADPCMState state{};
+    StereoBuffer16 output;
+
+    Codec::DecodeADPCM(data.data(), 5, coeffs, state, output);
+    REQUIRE(output.size() == 6);
+    const std::array<s16, 6> expected{{1, 2, 3, 4, -1, 0}};
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(output[i] == std::array<s16, 2>{{expected[i], expected[i]}});
+    }
+}
+
+TEST_CASE("Decoding into a reused buffer does not allocate", "[audio_core]") {
+    std::vector<u8> data(0x1000 * sizeof(s16) * 2, 0x55);
+    StereoBuffer16 output;
+    output.reserve(0x1002);
+    const auto* const storage = output.data();
+
+    for (int i = 0; i < 1000; ++i) {
+        output.assign({{}, {}});
+        Codec::DecodePCM16(2, data.data(), 0x1000, output);
+        REQUIRE(output.data() == storage);
+    }
+}
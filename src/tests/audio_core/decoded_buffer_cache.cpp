@@ -0,0 +1,84 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <catch2/catch.hpp>
+#include "audio_core/codec.h"
+#include "audio_core/hle/decoded_buffer_cache.h"
+
+using namespace AudioCore;
+
+namespace {
+
+constexpr std::array<s16, 16> coeffs{
+    {0x700, -0x300, 0x400, 0, 0x800, -0x200, 0x100, 0x100, 0, 0, -0x100, 0x300, 0, 0, 0, 0}};
+
+// Two ADPCM frames followed by a partial one, 33 samples in total
+std::array<u8, 24> MakeADPCMData() {
+    std::array<u8, 24> data;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<u8>(i * 37 + 11);
+    }
+    return data;
+}
+
+constexpr std::size_t sample_count = 33;
+
+} // anonymous namespace
+
+TEST_CASE("DecodedBufferCache matches the decoder", "[audio_core]") {
+    const auto data = MakeADPCMData();
+    HLE::DecodedBufferCache cache;
+
+    StereoBuffer16 expected{{{1, 2}}};
+    Codec::ADPCMState expected_state{100, -50};
+    Codec::DecodeADPCM(data.data(), sample_count, coeffs, expected_state, expected);
+
+    // The first call decodes and fills the cache, the second one is served from it
+    for (int i = 0; i < 2; ++i) {
+        StereoBuffer16 output{{{1, 2}}};
+        Codec::ADPCMState state{100, -50};
+        cache.DecodeADPCM(0x20000000, data.data(), sample_count, coeffs, state, output);
+        REQUIRE(output == expected);
+        REQUIRE(state.yn1 == expected_state.yn1);
+        REQUIRE(state.yn2 == expected_state.yn2);
+    }
+}
+
+TEST_CASE("DecodedBufferCache does not return stale samples", "[audio_core]") {
+    auto data = MakeADPCMData();
+    HLE::DecodedBufferCache cache;
+
+    StereoBuffer16 output;
+    Codec::ADPCMState state{0, 0};
+    cache.DecodeADPCM(0x20000000, data.data(), sample_count, coeffs, state, output);
+
+    SECTION("modified data") {
+        data[20] ^= 0x55;
+
+        StereoBuffer16 expected;
+        Codec::ADPCMState expected_state{0, 0};
+        Codec::DecodeADPCM(data.data(), sample_count, coeffs, expected_state, expected);
+
+        output.clear();
+        state = {0, 0};
+        cache.DecodeADPCM(0x20000000, data.data(), sample_count, coeffs, state, output);
+        REQUIRE(output == expected);
+        REQUIRE(state.yn1 == expected_state.yn1);
+        REQUIRE(state.yn2 == expected_state.yn2);
+    }
+
+    SECTION("different decoder state") {
+        StereoBuffer16 expected;
+        Codec::ADPCMState expected_state{1000, 2000};
+        Codec::DecodeADPCM(data.data(), sample_count, coeffs, expected_state, expected);
+
+        output.clear();
+        state = {1000, 2000};
+        cache.DecodeADPCM(0x20000000, data.data(), sample_count, coeffs, state, output);
+        REQUIRE(output == expected);
+        REQUIRE(state.yn1 == expected_state.yn1);
+        REQUIRE(state.yn2 == expected_state.yn2);
+    }
+}
@@ -0,0 +1,131 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/hle.h"
+#include "audio_core/hle/shared_memory.h"
+#include "core/core_timing.h"
+#include "core/memory.h"
+#include "core/settings.h"
+
+using namespace AudioCore;
+
+namespace {
+
+constexpr u64 audio_frame_ticks = 1310252ull; // Copied from DspHle internals
+
+/// Size of the memory holding the buffer of each source
+constexpr u32 source_data_size = 0x4000;
+
+struct RenderedFrames {
+    std::vector<s16> samples;
+    std::vector<u8> statuses;
+};
+
+/// Configures every source to play a looping buffer of noise, with a different format, rate and
+/// interpolation mode per source, and every intermediate mixer to be heard
+void SetupSources(HLE::SharedMemory& region) {
+    for (std::size_t i = 0; i < HLE::num_sources; ++i) {
+        auto& config = region.source_configurations.config[i];
+        using Configuration = HLE::SourceConfiguration::Configuration;
+
+        config.enable = 1;
+        config.enable_dirty.Assign(1);
+        config.rate_multiplier = 0.5f + 0.15f * static_cast<float>(i % 8);
+        config.rate_multiplier_dirty.Assign(1);
+        config.interpolation_mode = static_cast<Configuration::InterpolationMode>(i % 3);
+        config.interpolation_dirty.Assign(1);
+
+        for (std::size_t mix = 0; mix < 3; ++mix) {
+            for (std::size_t channel = 0; channel < 4; ++channel) {
+                config.gain[mix][channel] =
+                    mix == i % 3 ? 0.04f + 0.01f * static_cast<float>(channel) : 0.0f;
+            }
+        }
+        config.gain_0_dirty.Assign(1);
+        config.gain_1_dirty.Assign(1);
+        config.gain_2_dirty.Assign(1);
+
+        for (std::size_t c = 0; c < 16; ++c) {
+            region.adpcm_coefficients.coeff[i][c] =
+                static_cast<s16>((c * 0x1F3 + i * 0x47) % 0x800);
+        }
+        config.adpcm_coefficients_dirty.Assign(1);
+
+        config.physical_address = Memory::VRAM_PADDR + static_cast<u32>(i) * source_data_size;
+        config.length = 1000 + static_cast<u32>(i) * 37;
+        config.format.Assign(static_cast<Configuration::Format>(i % 3));
+        config.mono_or_stereo.Assign(i % 2 == 0 ? Configuration::MonoOrStereo::Mono
+                                                : Configuration::MonoOrStereo::Stereo);
+        config.is_looping.Assign(1);
+        config.buffer_id = static_cast<u16>(i + 1);
+        config.embedded_buffer_dirty.Assign(1);
+    }
+
+    for (std::size_t mix = 0; mix < 3; ++mix) {
+        region.dsp_configuration.volume[mix] = 1.0f;
+    }
+    region.dsp_configuration.volume_0_dirty.Assign(1);
+    region.dsp_configuration.volume_1_dirty.Assign(1);
+    region.dsp_configuration.volume_2_dirty.Assign(1);
+}
+
+RenderedFrames RenderFrames(bool multithreaded, std::size_t num_frames) {
+    Settings::values.enable_dsp_multithreading = multithreaded;
+
+    std::mt19937 rng(1234);
+    u8* const source_data = Memory::GetPhysicalPointer(Memory::VRAM_PADDR);
+    std::generate_n(source_data, HLE::num_sources * source_data_size,
+                    [&rng] { return static_cast<u8>(rng()); });
+
+    RenderedFrames rendered;
+    CoreTiming::Init();
+    {
+        DspHle dsp;
+        auto& dsp_memory = *reinterpret_cast<HLE::DspMemory*>(dsp.GetDspMemory().data());
+
+        // With equal frame counters the DSP reads from region 1 and writes to region 0
+        SetupSources(dsp_memory.region_1);
+
+        CoreTiming::Advance();
+        for (std::size_t frame = 0; frame < num_frames; ++frame) {
+            while (CoreTiming::GetTicks() < (frame + 1) * audio_frame_ticks) {
+                CoreTiming::AddTicks(CoreTiming::GetDowncount());
+                CoreTiming::Advance();
+            }
+
+            const HLE::SharedMemory& written = dsp_memory.region_0;
+            for (const auto& sample : written.final_samples.pcm16) {
+                rendered.samples.push_back(sample[0]);
+                rendered.samples.push_back(sample[1]);
+            }
+            const auto* status = reinterpret_cast<const u8*>(&written.source_statuses);
+            rendered.statuses.insert(rendered.statuses.end(), status,
+                                     status + sizeof(written.source_statuses));
+        }
+    }
+    CoreTiming::Shutdown();
+
+    return rendered;
+}
+
+} // anonymous namespace
+
+TEST_CASE("DSP multithreading gives the same output", "[audio_core]") {
+    const bool was_multithreaded = Settings::values.enable_dsp_multithreading;
+    constexpr std::size_t num_frames = 60;
+
+    const RenderedFrames serial = RenderFrames(false, num_frames);
+    const RenderedFrames parallel = RenderFrames(true, num_frames);
+    Settings::values.enable_dsp_multithreading = was_multithreaded;
+
+    REQUIRE(std::any_of(serial.samples.begin(), serial.samples.end(),
+                        [](s16 sample) { return sample != 0; }));
+    REQUIRE(serial.samples == parallel.samples);
+    REQUIRE(serial.statuses == parallel.statuses);
+}
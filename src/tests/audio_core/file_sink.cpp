@@ -0,0 +1,79 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include "audio_core/audio_types.h"
+#include "audio_core/file_sink.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+
+using namespace AudioCore;
+
+namespace {
+
+constexpr std::size_t num_frames = 3;
+
+/// Generates num_frames distinct DSP frames
+std::vector<StereoFrame16> MakeFrames() {
+    std::vector<StereoFrame16> frames(num_frames);
+    for (std::size_t f = 0; f < num_frames; ++f) {
+        for (std::size_t i = 0; i < samples_per_frame; ++i) {
+            frames[f][i][0] = static_cast<s16>(f * 1000 + i);
+            frames[f][i][1] = static_cast<s16>(-static_cast<s16>(f * 1000 + i));
+        }
+    }
+    return frames;
+}
+
+std::vector<u8> ReadFile(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    std::vector<u8> data(file.GetSize());
+    file.ReadBytes(data.data(), data.size());
+    return data;
+}
+
+u32 ReadU32(const std::vector<u8>& data, std::size_t offset) {
+    return data[offset] | data[offset + 1] << 8 | data[offset + 2] << 16 | data[offset + 3] << 24;
+}
+
+} // anonymous namespace
+
+TEST_CASE("FileSink records the DSP frames and their hashes", "[audio_core]") {
+    const std::string path = "file_sink_test.wav";
+    const std::vector<StereoFrame16> frames = MakeFrames();
+    constexpr std::size_t frame_size = samples_per_frame * 2 * sizeof(s16);
+
+    {
+        FileSink sink(path);
+        for (const auto& frame : frames) {
+            REQUIRE(sink.PushSamples(frame[0].data(), frame.size()));
+        }
+    }
+
+    const std::vector<u8> wav = ReadFile(path);
+    REQUIRE(wav.size() == 44 + num_frames * frame_size);
+    REQUIRE(std::memcmp(wav.data(), "RIFF", 4) == 0);
+    REQUIRE(ReadU32(wav, 4) == wav.size() - 8);
+    REQUIRE(std::memcmp(wav.data() + 8, "WAVEfmt ", 8) == 0);
+    REQUIRE(ReadU32(wav, 24) == native_sample_rate);
+    REQUIRE(std::memcmp(wav.data() + 36, "data", 4) == 0);
+    REQUIRE(ReadU32(wav, 40) == num_frames * frame_size);
+
+    std::string expected_hashes;
+    for (std::size_t f = 0; f < num_frames; ++f) {
+        REQUIRE(std::memcmp(wav.data() + 44 + f * frame_size, frames[f].data(), frame_size) == 0);
+        expected_hashes +=
+            fmt::format("{:016X}\n", Common::ComputeHash64(frames[f].data(), frame_size));
+    }
+
+    const std::vector<u8> hashes = ReadFile(path + ".hashes");
+    REQUIRE(std::string(hashes.begin(), hashes.end()) == expected_hashes);
+
+    FileUtil::Delete(path);
+    FileUtil::Delete(path + ".hashes");
+}
@@ -0,0 +1,97 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+#include <catch2/catch.hpp>
+#include "audio_core/interpolate.h"
+
+using namespace AudioCore;
+
+namespace {
+
+StereoBuffer16 MakeRamp(std::size_t begin, std::size_t end) {
+    StereoBuffer16 ramp;
+    for (std::size_t i = begin; i < end; ++i) {
+        ramp.push_back({{static_cast<s16>(i * 100), static_cast<s16>(-static_cast<int>(i) * 50)}});
+    }
+    return ramp;
+}
+
+/// Resamples the given buffers one after the other, the way Source does
+template <typename Interpolate>
+StereoFrame16 Resample(Interpolate interpolate, float rate,
+                       std::initializer_list<StereoBuffer16> buffers) {
+    AudioInterp::State state;
+    StereoFrame16 output{};
+    std::size_t outputi = 0;
+
+    StereoBuffer16 input;
+    for (const auto& buffer : buffers) {
+        input.assign({state.xn2, state.xn1});
+        input.insert(input.end(), buffer.begin(), buffer.end());
+
+        std::size_t inputi = 0;
+        while (outputi < output.size() && inputi + 2 < input.size()) {
+            interpolate(state, input, inputi, rate, output, outputi);
+        }
+    }
+    return output;
+}
+
+} // anonymous namespace
+
+TEST_CASE("AudioInterp::None has a two sample predelay", "[audio_core]") {
+    const StereoBuffer16 input = MakeRamp(0, 200);
+    const StereoFrame16 output = Resample(AudioInterp::None, 1.0f, {input});
+
+    REQUIRE(output[0] == std::array<s16, 2>{});
+    REQUIRE(output[1] == std::array<s16, 2>{});
+    for (std::size_t i = 2; i < output.size(); ++i) {
+        REQUIRE(output[i] == input[i - 2]);
+    }
+}
+
+TEST_CASE("AudioInterp results do not depend on buffer boundaries", "[audio_core]") {
+    for (const float rate : {0.75f, 1.0f, 1.5f}) {
+        const StereoFrame16 whole = Resample(AudioInterp::Linear, rate, {MakeRamp(0, 300)});
+        const StereoFrame16 split = Resample(
+            AudioInterp::Linear, rate, {MakeRamp(0, 7), MakeRamp(7, 100), MakeRamp(100, 300)});
+        INFO("rate " << rate);
+        REQUIRE(whole == split);
+    }
+}
+
+TEST_CASE("AudioInterp::Linear matches the reference formula", "[audio_core]") {
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> sample_dist(-32768, 32767);
+    StereoBuffer16 input;
+    for (std::size_t i = 0; i < 400; ++i) {
+        input.push_back({{static_cast<s16>(sample_dist(rng)), static_cast<s16>(sample_dist(rng))}});
+    }
+
+    for (const float rate : {0.3f, 1.0f, 2.25f}) {
+        const StereoFrame16 output = Resample(AudioInterp::Linear, rate, {input});
+
+        const u64 step_size = static_cast<u64>(rate * (1 << 24));
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            const u64 fposition = i * step_size;
+            const std::size_t samplei = fposition >> 24;
+            const auto sample = [&input](std::size_t index) {
+                return index < 2 ? std::array<s16, 2>{} : input[index - 2];
+            };
+            const auto x0 = sample(samplei);
+            const auto x1 = sample(samplei + 1);
+            for (std::size_t channel = 0; channel < 2; ++channel) {
+                const s64 delta = std::clamp<s64>(x1[channel] - x0[channel], -32768, 32767);
+                const u64 fraction = fposition & ((1 << 24) - 1);
+                const auto expected = static_cast<s16>(x0[channel] + fraction * delta / (1 << 24));
+                INFO("rate " << rate << " sample " << i << " channel " << channel);
+                REQUIRE(output[i][channel] == expected);
+            }
+        }
+    }
+}
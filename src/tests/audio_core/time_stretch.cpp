@@ -0,0 +1,113 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include "audio_core/audio_types.h"
+#include "audio_core/time_stretch.h"
+#include "audio_core/wsola.h"
+
+using namespace AudioCore;
+
+namespace {
+
+/// Generates a stereo sine wave with a period of 64 frames
+std::vector<s16> MakeSine(std::size_t num_frames) {
+    std::vector<s16> samples(num_frames * 2);
+    for (std::size_t i = 0; i < num_frames; ++i) {
+        const double phase = 2.0 * 3.14159265358979 * static_cast<double>(i) / 64.0;
+        samples[i * 2 + 0] = static_cast<s16>(std::sin(phase) * 10000.0);
+        samples[i * 2 + 1] = static_cast<s16>(std::cos(phase) * 10000.0);
+    }
+    return samples;
+}
+
+/// Feeds the input to the stretcher in blocks of 160 frames and collects all of its output
+std::vector<s16> Stretch(WSOLAStretcher& wsola, const std::vector<s16>& input) {
+    std::vector<s16> output;
+    std::vector<s16> block(4096 * 2);
+    const auto receive = [&] {
+        while (const std::size_t frames = wsola.ReceiveSamples(block.data(), 4096)) {
+            output.insert(output.end(), block.begin(), block.begin() + frames * 2);
+        }
+    };
+    for (std::size_t i = 0; i < input.size(); i += 160 * 2) {
+        wsola.PutSamples(input.data() + i, 160);
+        receive();
+    }
+    wsola.Flush();
+    receive();
+    return output;
+}
+
+} // anonymous namespace
+
+TEST_CASE("WSOLAStretcher keeps the length at a tempo of 1", "[audio_core]") {
+    const std::vector<s16> input = MakeSine(160 * 200);
+    WSOLAStretcher wsola;
+    const std::vector<s16> output = Stretch(wsola, input);
+    REQUIRE(output.size() == input.size());
+}
+
+TEST_CASE("WSOLAStretcher changes the length by the tempo", "[audio_core]") {
+    const std::vector<s16> input = MakeSine(160 * 200);
+    for (const double tempo : {0.5, 0.8, 1.25, 2.0}) {
+        WSOLAStretcher wsola;
+        wsola.SetTempo(tempo);
+        const std::vector<s16> output = Stretch(wsola, input);
+
+        // The unprocessed remainder of the input is flushed as it is
+        const double expected = static_cast<double>(input.size()) / tempo;
+        REQUIRE(std::abs(static_cast<double>(output.size()) - expected) < 0.1 * expected);
+    }
+}
+
+TEST_CASE("WSOLAStretcher joins segments at matching positions", "[audio_core]") {
+    const std::vector<s16> input = MakeSine(160 * 200);
+    WSOLAStretcher wsola;
+    wsola.SetTempo(0.7);
+    const std::vector<s16> output = Stretch(wsola, input);
+
+    // A sine with a period of 64 frames and an amplitude of 10000 changes by less than 1000 per
+    // frame, a badly placed segment would cause a jump in the waveform
+    for (std::size_t i = 2; i < output.size(); ++i) {
+        REQUIRE(std::abs(output[i] - output[i - 2]) < 1100);
+    }
+}
+
+TEST_CASE("TimeStretcher backend comparison", "[audio_core][.benchmark]") {
+    constexpr std::size_t block_frames = 160;
+    constexpr std::size_t num_blocks = native_sample_rate * 60 / block_frames;
+    const std::vector<s16> input = MakeSine(block_frames);
+    std::vector<s16> output(block_frames * 2 * 2);
+
+    for (const auto algorithm :
+         {Settings::TimeStretchAlgorithm::WSOLA, Settings::TimeStretchAlgorithm::SoundTouch}) {
+        TimeStretcher stretcher(algorithm);
+
+        // Emulation running at about 90% speed, the output asks for more than the input provides
+        std::size_t frames_in = 0;
+        std::size_t first_output = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < num_blocks; ++i) {
+            const std::size_t num_in = i % 10 == 0 ? 0 : block_frames;
+            frames_in += num_in;
+            const std::size_t frames_out =
+                stretcher.Process(input.data(), num_in, output.data(), block_frames);
+            if (frames_out != 0 && first_output == 0) {
+                first_output = frames_in;
+            }
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        fmt::print("{}: {:.2f} ms of CPU time per second of audio, first output after {:.1f} ms\n",
+                   algorithm == Settings::TimeStretchAlgorithm::WSOLA ? "WSOLA" : "SoundTouch",
+                   std::chrono::duration<double, std::milli>(elapsed).count() / 60.0,
+                   first_output * 1000.0 / native_sample_rate);
+    }
+}
@@ -0,0 +1,30 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/worker_pool.h"
+
+namespace Common {
+
+TEST_CASE("WorkerPool runs every task once", "[common]") {
+    for (const unsigned num_workers : {0u, 1u, 3u}) {
+        WorkerPool pool("WorkerPoolTest", num_workers);
+        REQUIRE(pool.NumThreads() == num_workers + 1);
+
+        // The pool is reused for many calls, like it is for every audio frame
+        for (std::size_t count : {0, 1, 2, 7, 100}) {
+            for (int call = 0; call < 50; ++call) {
+                std::vector<std::atomic<int>> calls(count);
+                pool.ParallelFor(count, [&calls](std::size_t i) { ++calls[i]; });
+                for (const auto& c : calls) {
+                    REQUIRE(c == 1);
+                }
+            }
+        }
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,108 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "common/file_util.h"
+#include "core/file_sys/romfs_reader.h"
+
+namespace FileSys {
+
+namespace {
+
+constexpr std::size_t file_offset = 0x200;
+constexpr std::size_t crypto_offset = 0x1000;
+constexpr std::array<u8, 16> key{{0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE, 0x01, 0x23,
+                                  0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF}};
+constexpr std::array<u8, 16> ctr{{0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87, 0, 0, 0, 0, 0,
+                                  0, 0, 0}};
+
+std::vector<u8> MakeRomFS(std::size_t size) {
+    std::mt19937 rng(1234);
+    std::vector<u8> data(size);
+    for (u8& byte : data) {
+        byte = static_cast<u8>(rng());
+    }
+    return data;
+}
+
+/// Writes the RomFS at file_offset of a new file, encrypted if requested
+void WriteContainer(const std::string& path, std::vector<u8> data, bool encrypt) {
+    if (encrypt) {
+        CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption e(key.data(), key.size(), ctr.data());
+        e.Seek(crypto_offset);
+        e.ProcessData(data.data(), data.data(), data.size());
+    }
+
+    FileUtil::IOFile file(path, "wb");
+    const std::vector<u8> header(file_offset, 0xAA);
+    file.WriteBytes(header.data(), header.size());
+    file.WriteBytes(data.data(), data.size());
+}
+
+void CheckReads(RomFSReader& reader, const std::vector<u8>& data) {
+    std::vector<u8> buffer(data.size());
+    std::mt19937 rng(5678);
+
+    // Random small reads, which may cross block boundaries
+    for (int i = 0; i < 1000; ++i) {
+        const std::size_t offset = rng() % data.size();
+        const std::size_t length = rng() % 0x3000 + 1;
+        const std::size_t expected = std::min(length, data.size() - offset);
+        REQUIRE(reader.ReadFile(offset, length, buffer.data()) == expected);
+        REQUIRE(std::memcmp(buffer.data(), data.data() + offset, expected) == 0);
+    }
+
+    // Sequential reads
+    for (std::size_t offset = 0; offset < data.size(); offset += 0x1800) {
+        const std::size_t expected = std::min<std::size_t>(0x1800, data.size() - offset);
+        REQUIRE(reader.ReadFile(offset, 0x1800, buffer.data()) == expected);
+        REQUIRE(std::memcmp(buffer.data(), data.data() + offset, expected) == 0);
+    }
+
+    // One large read of everything
+    REQUIRE(reader.ReadFile(0, data.size() + 100, buffer.data()) == data.size());
+    REQUIRE(buffer == data);
+
+    REQUIRE(reader.ReadFile(data.size(), 16, buffer.data()) == 0);
+    REQUIRE(reader.ReadFile(data.size() + 16, 16, buffer.data()) == 0);
+}
+
+} // anonymous namespace
+
+TEST_CASE("RomFSReader reads encrypted RomFS", "[core][file_sys]") {
+    const std::string path = "romfs_reader_test_encrypted.bin";
+    const std::vector<u8> data = MakeRomFS(0x180123);
+    WriteContainer(path, data, true);
+
+    {
+        RomFSReader reader(FileUtil::IOFile(path, "rb"), file_offset, data.size(), key, ctr,
+                           crypto_offset);
+        REQUIRE(reader.GetSize() == data.size());
+        CheckReads(reader, data);
+    }
+
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("RomFSReader reads unencrypted RomFS", "[core][file_sys]") {
+    const std::string path = "romfs_reader_test_plain.bin";
+    const std::vector<u8> data = MakeRomFS(0x23456);
+    WriteContainer(path, data, false);
+
+    {
+        RomFSReader reader(FileUtil::IOFile(path, "rb"), file_offset, data.size());
+        CheckReads(reader, data);
+    }
+
+    FileUtil::Delete(path);
+}
+
+} // namespace FileSys
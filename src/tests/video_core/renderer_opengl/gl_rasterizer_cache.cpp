@@ -0,0 +1,131 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <glad/glad.h>
+#include "common/hash.h"
+#include "core/memory.h"
+#include "tests/video_core/renderer_opengl/gl_test_context.h"
+#include "video_core/renderer_opengl/gl_rasterizer_cache.h"
+#include "video_core/renderer_opengl/gl_state.h"
+
+using PixelFormat = SurfaceParams::PixelFormat;
+
+namespace {
+
+Surface CreateTextureSurface(PAddr addr, u32 width, u32 height) {
+    auto surface = std::make_shared<CachedSurface>();
+    surface->addr = addr;
+    surface->width = width;
+    surface->height = height;
+    surface->is_tiled = true;
+    surface->pixel_format = PixelFormat::RGBA8;
+    surface->UpdateParams();
+    return surface;
+}
+
+} // anonymous namespace
+
+TEST_CASE("CachedSurface::ComputeContentHash", "[video_core][renderer_opengl]") {
+    const Surface surface = CreateTextureSurface(Memory::VRAM_PADDR, 32, 16);
+    u8* const data = Memory::GetPhysicalPointer(surface->addr);
+    for (u32 i = 0; i < surface->size; ++i) {
+        data[i] = static_cast<u8>(i * 7);
+    }
+
+    const std::optional<u64> hash = surface->ComputeContentHash();
+    REQUIRE(hash);
+    REQUIRE(*hash == Common::ComputeHash64(data, surface->size));
+
+    SECTION("identical memory at another address has the same hash") {
+        const Surface copy = CreateTextureSurface(surface->end, 32, 16);
+        std::copy_n(data, surface->size, Memory::GetPhysicalPointer(copy->addr));
+        REQUIRE(copy->ComputeContentHash() == hash);
+    }
+
+    SECTION("changed memory changes the hash") {
+        data[surface->size - 1] ^= 1;
+        REQUIRE(surface->ComputeContentHash() != hash);
+    }
+
+    SECTION("surfaces that are not contiguous in host memory are not hashed") {
+        const Surface crossing = CreateTextureSurface(Memory::VRAM_PADDR_END - 0x400, 32, 16);
+        REQUIRE_FALSE(crossing->ComputeContentHash());
+
+        const Surface unmapped = CreateTextureSurface(0, 32, 16);
+        REQUIRE_FALSE(unmapped->ComputeContentHash());
+    }
+}
+
+TEST_CASE("CachedSurface content hash is invalidated with the texture",
+          "[video_core][renderer_opengl]") {
+    const Surface surface = CreateTextureSurface(Memory::VRAM_PADDR, 32, 16);
+    surface->content_hash = *surface->ComputeContentHash();
+    surface->content_hash_valid = true;
+
+    // Pool entries are only used while the hash of their surface is valid
+    const auto watcher = surface->CreateWatcher();
+    watcher->Validate();
+    surface->InvalidateAllWatcher();
+    REQUIRE_FALSE(surface->content_hash_valid);
+    REQUIRE_FALSE(watcher->IsValid());
+}
+
+TEST_CASE("CachedSurface reads back the same data through a pixel pack buffer",
+          "[video_core][renderer_opengl]") {
+    if (!OpenGLTests::MakeTestContextCurrent()) {
+        WARN("Skipped, no OpenGL context available");
+        return;
+    }
+
+    const Surface surface = CreateTextureSurface(Memory::VRAM_PADDR, 64, 32);
+    surface->is_tiled = false;
+    surface->UpdateParams();
+
+    std::mt19937 rng(1234);
+    std::vector<u32> pixels(surface->width * surface->height);
+    std::generate(pixels.begin(), pixels.end(), [&rng] { return static_cast<u32>(rng()); });
+
+    surface->texture.Create();
+    OpenGLState state = OpenGLState::GetCurState();
+    state.texture_units[0].texture_2d = surface->texture.handle;
+    state.Apply();
+    glActiveTexture(GL_TEXTURE0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, surface->width, surface->height, 0, GL_RGBA,
+                 GL_UNSIGNED_INT_8_8_8_8, pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    state.texture_units[0].texture_2d = 0;
+    state.Apply();
+
+    OGLFramebuffer read_framebuffer;
+    OGLFramebuffer draw_framebuffer;
+    read_framebuffer.Create();
+    draw_framebuffer.Create();
+
+    // Allocates gl_buffer
+    surface->DownloadGLTexture(surface->GetRect(), read_framebuffer.handle,
+                               draw_framebuffer.handle);
+
+    for (const auto& rect : {surface->GetRect(), MathUtil::Rectangle<u32>{8, 24, 40, 16}}) {
+        std::memset(surface->gl_buffer.get(), 0, surface->gl_buffer_size);
+        surface->DownloadGLTexture(rect, read_framebuffer.handle, draw_framebuffer.handle);
+        const std::vector<u8> expected(surface->gl_buffer.get(),
+                                       surface->gl_buffer.get() + surface->gl_buffer_size);
+
+        std::memset(surface->gl_buffer.get(), 0, surface->gl_buffer_size);
+        surface->cpu_read_hint = false;
+        surface->StartAsyncDownload(read_framebuffer.handle, draw_framebuffer.handle);
+        surface->DownloadGLTexture(rect, read_framebuffer.handle, draw_framebuffer.handle);
+        surface->DiscardAsyncDownload();
+
+        // The hint is only set when the synchronous path is taken
+        REQUIRE_FALSE(surface->cpu_read_hint);
+        REQUIRE(std::equal(expected.begin(), expected.end(), surface->gl_buffer.get()));
+    }
+}
@@ -0,0 +1,82 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef HAVE_SDL2
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#endif
+#include <glad/glad.h>
+#include "common/logging/log.h"
+#include "tests/video_core/renderer_opengl/gl_test_context.h"
+
+namespace OpenGLTests {
+
+#ifdef HAVE_SDL2
+
+namespace {
+
+class TestContext {
+public:
+    TestContext() {
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+            LOG_WARNING(Render_OpenGL, "Failed to initialize SDL2: {}", SDL_GetError());
+            return;
+        }
+        SDL_SetMainReady();
+
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+
+        window = SDL_CreateWindow("OpenGL tests", SDL_WINDOWPOS_UNDEFINED,
+                                  SDL_WINDOWPOS_UNDEFINED, 64, 64,
+                                  SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+        if (window == nullptr) {
+            LOG_WARNING(Render_OpenGL, "Failed to create SDL2 window: {}", SDL_GetError());
+            return;
+        }
+
+        context = SDL_GL_CreateContext(window);
+        if (context == nullptr) {
+            LOG_WARNING(Render_OpenGL, "Failed to create SDL2 GL context: {}", SDL_GetError());
+            return;
+        }
+
+        valid = gladLoadGLLoader(static_cast<GLADloadproc>(SDL_GL_GetProcAddress)) != 0;
+    }
+
+    ~TestContext() {
+        if (context != nullptr)
+            SDL_GL_DeleteContext(context);
+        if (window != nullptr)
+            SDL_DestroyWindow(window);
+        SDL_Quit();
+    }
+
+    bool IsValid() const {
+        return valid;
+    }
+
+private:
+    SDL_Window* window = nullptr;
+    SDL_GLContext context = nullptr;
+    bool valid = false;
+};
+
+} // anonymous namespace
+
+bool MakeTestContextCurrent() {
+    static const TestContext context;
+    return context.IsValid();
+}
+
+#else
+
+bool MakeTestContextCurrent() {
+    return false;
+}
+
+#endif
+
+} // namespace OpenGLTests
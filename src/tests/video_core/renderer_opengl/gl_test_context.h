@@ -0,0 +1,17 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+namespace OpenGLTests {
+
+/**
+ * Makes an OpenGL 3.3 core context current on the calling thread and loads the GL functions. The
+ * context belongs to a hidden window, it is created on the first call and kept until the tests
+ * exit.
+ * @returns false if no context could be created, in which case OpenGL tests should be skipped
+ */
+bool MakeTestContextCurrent();
+
+} // namespace OpenGLTests
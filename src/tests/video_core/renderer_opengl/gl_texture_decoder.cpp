@@ -0,0 +1,110 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <glad/glad.h>
+#include "tests/video_core/renderer_opengl/gl_test_context.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+#include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/renderer_opengl/gl_texture_decoder.h"
+#include "video_core/texture/texture_decode.h"
+
+using TextureFormat = Pica::TexturingRegs::TextureFormat;
+
+namespace {
+
+/// Value of the texels that are not decoded to
+constexpr u8 clear_value = 0xCD;
+
+/// Runs func with the texture bound to GL_TEXTURE_2D of the first texture unit
+template <typename Func>
+void WithTextureBound(GLuint texture, Func func) {
+    OpenGLState state = OpenGLState::GetCurState();
+    const GLuint old_texture = state.texture_units[0].texture_2d;
+    state.texture_units[0].texture_2d = texture;
+    state.Apply();
+    glActiveTexture(GL_TEXTURE0);
+
+    func();
+
+    state.texture_units[0].texture_2d = old_texture;
+    state.Apply();
+}
+
+void CheckComputeDecoderMatchesCPU(ComputeTextureDecoder& decoder, TextureFormat format,
+                                   const MathUtil::Rectangle<u32>& rect) {
+    Pica::Texture::TextureInfo info{};
+    info.width = 64;
+    info.height = 32;
+    info.format = format;
+    info.SetDefaultStride();
+
+    std::mt19937 rng(static_cast<u32>(format));
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+    std::vector<u8> source(info.stride * (info.height / 8));
+    for (u8& byte : source) {
+        byte = static_cast<u8>(byte_dist(rng));
+    }
+
+    std::vector<u8> expected(info.width * info.height * 4);
+    Pica::Texture::DecodeTexture(info, source.data(), expected.data());
+
+    OGLTexture texture;
+    texture.Create();
+    const std::vector<u8> cleared(expected.size(), clear_value);
+    WithTextureBound(texture.handle, [&] {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, info.width, info.height, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, cleared.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    });
+
+    REQUIRE(decoder.Decode(info, source.data(), rect, texture.handle,
+                           static_cast<GLint>(rect.left), static_cast<GLint>(rect.bottom)));
+
+    std::vector<u8> decoded(expected.size());
+    WithTextureBound(texture.handle, [&] {
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, decoded.data());
+    });
+
+    // Rows of the OpenGL texture go bottom to top, those decoded on the CPU top to bottom
+    for (unsigned y = 0; y < info.height; ++y) {
+        for (unsigned x = 0; x < info.width; ++x) {
+            const bool inside =
+                x >= rect.left && x < rect.right && y >= rect.bottom && y < rect.top;
+            const u8* texel = &decoded[(x + y * info.width) * 4];
+            const u8* expected_texel = &expected[(x + (info.height - 1 - y) * info.width) * 4];
+            INFO("format " << static_cast<u32>(format) << " at (" << x << ", " << y << ")");
+            for (unsigned component = 0; component < 4; ++component) {
+                REQUIRE(texel[component] == (inside ? expected_texel[component] : clear_value));
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+TEST_CASE("ComputeTextureDecoder matches DecodeTexture", "[video_core][renderer_opengl]") {
+    if (!OpenGLTests::MakeTestContextCurrent() || !ComputeTextureDecoder::IsSupported()) {
+        WARN("Skipped, the compute texture decoder is not supported");
+        return;
+    }
+
+    const TextureFormat formats[] = {
+        TextureFormat::RGBA8, TextureFormat::RGB8, TextureFormat::RGB5A1, TextureFormat::RGB565,
+        TextureFormat::RGBA4, TextureFormat::IA8,  TextureFormat::RG8,    TextureFormat::I8,
+        TextureFormat::A8,    TextureFormat::IA4,  TextureFormat::I4,     TextureFormat::A4,
+        TextureFormat::ETC1,  TextureFormat::ETC1A4,
+    };
+
+    ComputeTextureDecoder decoder;
+    for (TextureFormat format : formats) {
+        // The whole texture, and a rectangle that starts in neither the first row nor column
+        CheckComputeDecoderMatchesCPU(decoder, format, {0, 32, 64, 0});
+        CheckComputeDecoderMatchesCPU(decoder, format, {16, 24, 48, 8});
+    }
+}
@@ -0,0 +1,56 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "video_core/texture/texture_decode.h"
+
+using TextureFormat = Pica::TexturingRegs::TextureFormat;
+
+static void CheckDecodeTextureMatchesLookup(TextureFormat format, bool disable_alpha) {
+    Pica::Texture::TextureInfo info{};
+    info.width = 32;
+    info.height = 16;
+    info.format = format;
+    info.SetDefaultStride();
+
+    std::mt19937 rng(static_cast<u32>(format));
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+    std::vector<u8> source(info.stride * (info.height / 8));
+    for (u8& byte : source) {
+        byte = static_cast<u8>(byte_dist(rng));
+    }
+
+    std::vector<u8> decoded(info.width * info.height * 4);
+    Pica::Texture::DecodeTexture(info, source.data(), decoded.data(), disable_alpha);
+
+    for (unsigned y = 0; y < info.height; ++y) {
+        for (unsigned x = 0; x < info.width; ++x) {
+            const auto expected =
+                Pica::Texture::LookupTexture(source.data(), x, y, info, disable_alpha);
+            const u8* texel = &decoded[(x + y * info.width) * 4];
+            INFO("format " << static_cast<u32>(format) << " at (" << x << ", " << y << ")");
+            REQUIRE(texel[0] == expected.r());
+            REQUIRE(texel[1] == expected.g());
+            REQUIRE(texel[2] == expected.b());
+            REQUIRE(texel[3] == expected.a());
+        }
+    }
+}
+
+TEST_CASE("DecodeTexture matches LookupTexture", "[video_core][texture]") {
+    const TextureFormat formats[] = {
+        TextureFormat::RGBA8, TextureFormat::RGB8, TextureFormat::RGB5A1, TextureFormat::RGB565,
+        TextureFormat::RGBA4, TextureFormat::IA8,  TextureFormat::RG8,    TextureFormat::I8,
+        TextureFormat::A8,    TextureFormat::IA4,  TextureFormat::I4,     TextureFormat::A4,
+        TextureFormat::ETC1,  TextureFormat::ETC1A4,
+    };
+
+    for (TextureFormat format : formats) {
+        CheckDecodeTextureMatchesLookup(format, false);
+        CheckDecodeTextureMatchesLookup(format, true);
+    }
+}
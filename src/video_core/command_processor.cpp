@@ -119,6 +119,34 @@ static void WriteUniformFloatReg(ShaderRegs& config, Shader::ShaderSetup& setup,
     }
 }
 
+/// Returns whether the register is one of the ports the LUTs are uploaded through
+static bool IsLutDataRegister(u32 id) {
+    const auto is_in = [id](u32 first, u32 last) { return id >= first && id <= last; };
+    return is_in(PICA_REG_INDEX_WORKAROUND(lighting.lut_data[0], 0x1c8),
+                 PICA_REG_INDEX_WORKAROUND(lighting.lut_data[7], 0x1cf)) ||
+           is_in(PICA_REG_INDEX_WORKAROUND(texturing.fog_lut_data[0], 0xe8),
+                 PICA_REG_INDEX_WORKAROUND(texturing.fog_lut_data[7], 0xef)) ||
+           is_in(PICA_REG_INDEX_WORKAROUND(texturing.proctex_lut_data[0], 0xb0),
+                 PICA_REG_INDEX_WORKAROUND(texturing.proctex_lut_data[7], 0xb7));
+}
+
+/**
+ * Writes a LUT entry through one of the LUT data registers. The rasterizer is only notified if the
+ * entry changes, as many titles upload the same tables every frame.
+ * @returns whether the entry changed
+ */
+template <typename Entry>
+static bool WriteLutEntry(u32 id, Entry& entry, u32 value) {
+    if (entry.raw == value) {
+        MICROPROFILE_META_CPU("Unchanged LUT Writes", 1);
+        return false;
+    }
+
+    VideoCore::g_renderer->Rasterizer()->NotifyPicaRegisterWrite(id, value);
+    entry.raw = value;
+    return true;
+}
+
 static void WritePicaReg(u32 id, u32 value, u32 mask) {
     auto& regs = g_state.regs;
 
@@ -135,7 +163,17 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
 
     const u32 write_mask = expand_bits_to_bytes[mask];
 
-    regs.reg_array[id] = (old_value & ~write_mask) | (value & write_mask);
+    const u32 new_value = (old_value & ~write_mask) | (value & write_mask);
+
+    // Writes to the LUT data registers are reported when the LUT entry itself is written
+    const bool is_lut_data = IsLutDataRegister(id);
+    bool lut_changed = false;
+
+    // Let the rasterizer draw the triangles it holds back before the state they depend on changes
+    if (!is_lut_data)
+        VideoCore::g_renderer->Rasterizer()->NotifyPicaRegisterWrite(id, new_value);
+
+    regs.reg_array[id] = new_value;
 
     // Double check for is_pica_tracing to avoid call overhead
     if (DebugUtils::IsPicaTracing()) {
@@ -247,9 +285,8 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
                     g_state.geometry_pipeline.Setup(shader_engine);
                     g_state.geometry_pipeline.SubmitVertex(output);
 
-                    // TODO: If drawing after every immediate mode triangle kills performance,
-                    // change it to flush triangles whenever a drawing config register changes
-                    // See: https://github.com/citra-emu/citra/pull/2866#issuecomment-327011550
+                    // The rasterizer merges the triangles of consecutive batches, so this only
+                    // results in a draw once a drawing config register changes
                     VideoCore::g_renderer->Rasterizer()->DrawTriangles();
                     if (g_debug_context) {
                         g_debug_context->OnEvent(DebugContext::Event::FinishedPrimitiveBatch,
@@ -591,7 +628,8 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
 
         ASSERT_MSG(lut_config.index < 256, "lut_config.index exceeded maximum value of 255!");
 
-        g_state.lighting.luts[lut_config.type][lut_config.index].raw = value;
+        lut_changed =
+            WriteLutEntry(id, g_state.lighting.luts[lut_config.type][lut_config.index], value);
         lut_config.index.Assign(lut_config.index + 1);
         break;
     }
@@ -604,7 +642,8 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
     case PICA_REG_INDEX_WORKAROUND(texturing.fog_lut_data[5], 0xed):
     case PICA_REG_INDEX_WORKAROUND(texturing.fog_lut_data[6], 0xee):
     case PICA_REG_INDEX_WORKAROUND(texturing.fog_lut_data[7], 0xef): {
-        g_state.fog.lut[regs.texturing.fog_lut_offset % 128].raw = value;
+        lut_changed =
+            WriteLutEntry(id, g_state.fog.lut[regs.texturing.fog_lut_offset % 128], value);
         regs.texturing.fog_lut_offset.Assign(regs.texturing.fog_lut_offset + 1);
         break;
     }
@@ -622,19 +661,22 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
 
         switch (regs.texturing.proctex_lut_config.ref_table.Value()) {
         case TexturingRegs::ProcTexLutTable::Noise:
-            pt.noise_table[index % pt.noise_table.size()].raw = value;
+            lut_changed = WriteLutEntry(id, pt.noise_table[index % pt.noise_table.size()], value);
             break;
         case TexturingRegs::ProcTexLutTable::ColorMap:
-            pt.color_map_table[index % pt.color_map_table.size()].raw = value;
+            lut_changed =
+                WriteLutEntry(id, pt.color_map_table[index % pt.color_map_table.size()], value);
             break;
         case TexturingRegs::ProcTexLutTable::AlphaMap:
-            pt.alpha_map_table[index % pt.alpha_map_table.size()].raw = value;
+            lut_changed =
+                WriteLutEntry(id, pt.alpha_map_table[index % pt.alpha_map_table.size()], value);
             break;
         case TexturingRegs::ProcTexLutTable::Color:
-            pt.color_table[index % pt.color_table.size()].raw = value;
+            lut_changed = WriteLutEntry(id, pt.color_table[index % pt.color_table.size()], value);
             break;
         case TexturingRegs::ProcTexLutTable::ColorDiff:
-            pt.color_diff_table[index % pt.color_diff_table.size()].raw = value;
+            lut_changed =
+                WriteLutEntry(id, pt.color_diff_table[index % pt.color_diff_table.size()], value);
             break;
         }
         index.Assign(index + 1);
@@ -644,7 +686,8 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         break;
     }
 
-    VideoCore::g_renderer->Rasterizer()->NotifyPicaRegisterChanged(id);
+    if (!is_lut_data || lut_changed)
+        VideoCore::g_renderer->Rasterizer()->NotifyPicaRegisterChanged(id);
 
     if (g_debug_context)
         g_debug_context->OnEvent(DebugContext::Event::PicaCommandProcessed,
@@ -671,6 +714,9 @@ void ProcessCommandList(const u32* list, u32 size) {
             WritePicaReg(cmd, *g_state.cmd_list.current_ptr++, header.parameter_mask);
         }
     }
+
+    // Draws must not be deferred past the end of the list, the framebuffer may be used afterwards
+    VideoCore::g_renderer->Rasterizer()->FlushTriangles();
 }
 
 } // namespace CommandProcessor
@@ -26,10 +26,20 @@ public:
                              const Pica::Shader::OutputVertex& v1,
                              const Pica::Shader::OutputVertex& v2) = 0;
 
-    /// Draw the current batch of triangles
+    /// Draw the current batch of triangles. The rasterizer may defer this and merge the batch with
+    /// the following ones until a register affecting them is written or memory is synchronized
     virtual void DrawTriangles() = 0;
 
-    /// Notify rasterizer that the specified PICA register has been changed
+    /// Draw the batches deferred by DrawTriangles. Called at the end of each command list and
+    /// before a frame is presented
+    virtual void FlushTriangles() {}
+
+    /// Notify rasterizer that the specified PICA register is about to be written with a new value.
+    /// For the LUT data registers, this is only called when the written LUT entry changes
+    virtual void NotifyPicaRegisterWrite(u32 id, u32 value) {}
+
+    /// Notify rasterizer that the specified PICA register has been changed. For the LUT data
+    /// registers, this is only called when the written LUT entry changed
     virtual void NotifyPicaRegisterChanged(u32 id) = 0;
 
     /// Notify rasterizer that all caches should be flushed to 3DS memory
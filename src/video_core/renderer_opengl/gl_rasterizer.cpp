@@ -15,7 +15,9 @@
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/vector_math.h"
+#include "core/core.h"
 #include "core/hw/gpu.h"
+#include "core/settings.h"
 #include "video_core/pica_state.h"
 #include "video_core/regs_framebuffer.h"
 #include "video_core/regs_rasterizer.h"
@@ -96,6 +98,8 @@ RasterizerOpenGL::RasterizerOpenGL(EmuWindow& window)
         Common::AlignUp<std::size_t>(sizeof(GSUniformData), uniform_buffer_alignment);
     uniform_size_aligned_fs =
         Common::AlignUp<std::size_t>(sizeof(UniformData), uniform_buffer_alignment);
+    uniform_size_aligned_uber =
+        Common::AlignUp<std::size_t>(sizeof(UberShaderUniformData), uniform_buffer_alignment);
 
     // Set vertex attributes for software shader path
     state.draw.vertex_array = sw_vao.handle;
@@ -151,8 +155,17 @@ RasterizerOpenGL::RasterizerOpenGL(EmuWindow& window)
     state.Apply();
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer.GetHandle());
 
-    shader_program_manager =
-        std::make_unique<ShaderProgramManager>(GLAD_GL_ARB_separate_shader_objects, is_amd);
+    // The disk shader cache is stored per title, there is no title id for homebrew formats
+    u64 title_id = 0;
+    Core::System::GetInstance().GetAppLoader().ReadProgramId(title_id);
+    const auto& uber_shader_titles = Settings::values.uber_shader_titles;
+    const bool use_uber_shader =
+        Settings::values.use_uber_shader ||
+        (title_id != 0 && std::find(uber_shader_titles.begin(), uber_shader_titles.end(),
+                                    title_id) != uber_shader_titles.end());
+    shader_program_manager = std::make_unique<ShaderProgramManager>(
+        GLAD_GL_ARB_separate_shader_objects, is_amd, title_id,
+        Settings::values.use_async_shader_compilation, use_uber_shader);
 
     glEnable(GL_BLEND);
 
@@ -395,6 +408,10 @@ bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
         }
     }
 
+    // The merged batch is drawn with the trivial shaders, so it has to go before the shaders of
+    // this draw are bound
+    FlushTriangles();
+
     if (!SetupVertexShader())
         return false;
 
@@ -476,11 +493,13 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed, bool use_gs)
         std::memcpy(buffer_ptr, index_data, index_buffer_size);
         index_buffer.Unmap(index_buffer_size);
 
+        MICROPROFILE_META_CPU("OpenGL Draw Calls", 1);
         glDrawRangeElementsBaseVertex(
             primitive_mode, vs_input_index_min, vs_input_index_max, regs.pipeline.num_vertices,
             index_u16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE,
             reinterpret_cast<const void*>(buffer_offset), -static_cast<GLint>(vs_input_index_min));
     } else {
+        MICROPROFILE_META_CPU("OpenGL Draw Calls", 1);
         glDrawArrays(primitive_mode, 0, regs.pipeline.num_vertices);
     }
     return true;
@@ -489,7 +508,22 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed, bool use_gs)
 void RasterizerOpenGL::DrawTriangles() {
     if (vertex_batch.empty())
         return;
+
+    // The batch is merged with the following ones and drawn once the state it depends on changes,
+    // which saves the state validation and the draw call of every batch in between
+    ++vertex_batch_count;
+    if (vertex_batch.size() >= MAX_MERGED_VERTICES)
+        FlushTriangles();
+}
+
+void RasterizerOpenGL::FlushTriangles() {
+    if (vertex_batch.empty())
+        return;
+
+    MICROPROFILE_META_CPU("Merged Triangle Batches", vertex_batch_count);
     Draw(false, false);
+    vertex_batch.clear();
+    vertex_batch_count = 0;
 }
 
 bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
@@ -794,10 +828,9 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
         shader_program_manager->ApplyTo(state);
         state.Apply();
 
-        std::size_t max_vertices = 3 * (VERTEX_BUFFER_SIZE / (3 * sizeof(HardwareVertex)));
         for (std::size_t base_vertex = 0; base_vertex < vertex_batch.size();
-             base_vertex += max_vertices) {
-            std::size_t vertices = std::min(max_vertices, vertex_batch.size() - base_vertex);
+             base_vertex += MAX_MERGED_VERTICES) {
+            std::size_t vertices = std::min(MAX_MERGED_VERTICES, vertex_batch.size() - base_vertex);
             std::size_t vertex_size = vertices * sizeof(HardwareVertex);
             u8* vbo;
             GLintptr offset;
@@ -805,12 +838,11 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
                 vertex_buffer.Map(vertex_size, sizeof(HardwareVertex));
             std::memcpy(vbo, vertex_batch.data() + base_vertex, vertex_size);
             vertex_buffer.Unmap(vertex_size);
+            MICROPROFILE_META_CPU("OpenGL Draw Calls", 1);
             glDrawArrays(GL_TRIANGLES, offset / sizeof(HardwareVertex), (GLsizei)vertices);
         }
     }
 
-    vertex_batch.clear();
-
     // Reset textures in rasterizer state context because the rasterizer cache might delete them
     for (unsigned texture_index = 0; texture_index < pica_textures.size(); ++texture_index) {
         state.texture_units[texture_index].texture_2d = 0;
@@ -855,6 +887,27 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     return succeeded;
 }
 
+void RasterizerOpenGL::NotifyPicaRegisterWrite(u32 id, u32 value) {
+    // Only the rasterizer, texturing, framebuffer and lighting registers affect vertices that were
+    // already processed by the shaders
+    if (vertex_batch.empty() || id >= PICA_REG_INDEX(pipeline))
+        return;
+
+    // The LUT data registers are only reported when they change a LUT entry, which is not
+    // reflected by the register value
+    const auto is_in = [id](u32 first, u32 last) { return id >= first && id <= last; };
+    const bool is_lut_data =
+        is_in(PICA_REG_INDEX_WORKAROUND(lighting.lut_data[0], 0x1c8),
+              PICA_REG_INDEX_WORKAROUND(lighting.lut_data[7], 0x1cf)) ||
+        is_in(PICA_REG_INDEX_WORKAROUND(texturing.fog_lut_data[0], 0xe8),
+              PICA_REG_INDEX_WORKAROUND(texturing.fog_lut_data[7], 0xef)) ||
+        is_in(PICA_REG_INDEX_WORKAROUND(texturing.proctex_lut_data[0], 0xb0),
+              PICA_REG_INDEX_WORKAROUND(texturing.proctex_lut_data[7], 0xb7));
+
+    if (is_lut_data || Pica::g_state.regs.reg_array[id] != value)
+        FlushTriangles();
+}
+
 void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
     const auto& regs = Pica::g_state.regs;
 
@@ -1342,27 +1395,32 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
 
 void RasterizerOpenGL::FlushAll() {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    FlushTriangles();
     res_cache.FlushAll();
 }
 
 void RasterizerOpenGL::FlushRegion(PAddr addr, u32 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    FlushTriangles();
     res_cache.FlushRegion(addr, size);
 }
 
 void RasterizerOpenGL::InvalidateRegion(PAddr addr, u32 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    FlushTriangles();
     res_cache.InvalidateRegion(addr, size, nullptr);
 }
 
 void RasterizerOpenGL::FlushAndInvalidateRegion(PAddr addr, u32 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    FlushTriangles();
     res_cache.FlushRegion(addr, size);
     res_cache.InvalidateRegion(addr, size, nullptr);
 }
 
 bool RasterizerOpenGL::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
     MICROPROFILE_SCOPE(OpenGL_Blits);
+    FlushTriangles();
 
     SurfaceParams src_params;
     src_params.addr = config.GetPhysicalInputAddress();
@@ -1413,6 +1471,8 @@ bool RasterizerOpenGL::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransfe
 }
 
 bool RasterizerOpenGL::AccelerateTextureCopy(const GPU::Regs::DisplayTransferConfig& config) {
+    FlushTriangles();
+
     u32 copy_size = Common::AlignDown(config.texture_copy.size, 16);
     if (copy_size == 0) {
         return false;
@@ -1498,6 +1558,8 @@ bool RasterizerOpenGL::AccelerateTextureCopy(const GPU::Regs::DisplayTransferCon
 }
 
 bool RasterizerOpenGL::AccelerateFill(const GPU::Regs::MemoryFillConfig& config) {
+    FlushTriangles();
+
     Surface dst_surface = res_cache.GetFillSurface(config);
     if (dst_surface == nullptr)
         return false;
@@ -1513,6 +1575,7 @@ bool RasterizerOpenGL::AccelerateDisplay(const GPU::Regs::FramebufferConfig& con
         return false;
     }
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    FlushTriangles();
 
     SurfaceParams src_params;
     src_params.addr = framebuffer_addr;
@@ -1589,7 +1652,12 @@ void RasterizerOpenGL::SamplerInfo::SyncWithConfig(
 
 void RasterizerOpenGL::SetShader() {
     auto config = GLShader::PicaFSConfig::BuildFromRegs(Pica::g_state.regs);
-    shader_program_manager->UseFragmentShader(config);
+    if (!shader_program_manager->UseFragmentShader(config)) {
+        // The specialized shader is still being compiled, the uber shader reads the configuration
+        // from its uniform block in the meantime
+        uber_uniform_block_data.data.SetFromConfig(config);
+        uber_uniform_block_data.dirty = true;
+    }
 }
 
 void RasterizerOpenGL::SyncClipEnabled() {
@@ -1922,6 +1990,8 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
     GLintptr offset;
     bool invalidate;
     std::size_t bytes_used = 0;
+    // LUTs marked dirty whose content turned out to be unchanged
+    std::size_t bytes_saved = 0;
     glBindBuffer(GL_TEXTURE_BUFFER, texture_buffer.GetHandle());
     std::tie(buffer, offset, invalidate) = texture_buffer.Map(max_size, sizeof(GLvec4));
 
@@ -1944,6 +2014,8 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
                         (offset + bytes_used) / sizeof(GLvec2);
                     uniform_block_data.dirty = true;
                     bytes_used += new_data.size() * sizeof(GLvec2);
+                } else {
+                    bytes_saved += new_data.size() * sizeof(GLvec2);
                 }
                 uniform_block_data.lighting_lut_dirty[index] = false;
             }
@@ -1966,12 +2038,14 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
             uniform_block_data.data.fog_lut_offset = (offset + bytes_used) / sizeof(GLvec2);
             uniform_block_data.dirty = true;
             bytes_used += new_data.size() * sizeof(GLvec2);
+        } else {
+            bytes_saved += new_data.size() * sizeof(GLvec2);
         }
         uniform_block_data.fog_lut_dirty = false;
     }
 
     // helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
-    auto SyncProcTexValueLUT = [this, buffer, offset, invalidate, &bytes_used](
+    auto SyncProcTexValueLUT = [this, buffer, offset, invalidate, &bytes_used, &bytes_saved](
                                    const std::array<Pica::State::ProcTex::ValueEntry, 128>& lut,
                                    std::array<GLvec2, 128>& lut_data, GLint& lut_offset) {
         std::array<GLvec2, 128> new_data;
@@ -1985,6 +2059,8 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
             lut_offset = (offset + bytes_used) / sizeof(GLvec2);
             uniform_block_data.dirty = true;
             bytes_used += new_data.size() * sizeof(GLvec2);
+        } else {
+            bytes_saved += new_data.size() * sizeof(GLvec2);
         }
     };
 
@@ -2026,6 +2102,8 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
             uniform_block_data.data.proctex_lut_offset = (offset + bytes_used) / sizeof(GLvec4);
             uniform_block_data.dirty = true;
             bytes_used += new_data.size() * sizeof(GLvec4);
+        } else {
+            bytes_saved += new_data.size() * sizeof(GLvec4);
         }
         uniform_block_data.proctex_lut_dirty = false;
     }
@@ -2048,11 +2126,16 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
                 (offset + bytes_used) / sizeof(GLvec4);
             uniform_block_data.dirty = true;
             bytes_used += new_data.size() * sizeof(GLvec4);
+        } else {
+            bytes_saved += new_data.size() * sizeof(GLvec4);
         }
         uniform_block_data.proctex_diff_lut_dirty = false;
     }
 
     texture_buffer.Unmap(bytes_used);
+
+    MICROPROFILE_META_CPU("LUT Upload Bytes", bytes_used);
+    MICROPROFILE_META_CPU("LUT Upload Bytes Saved", bytes_saved);
 }
 
 void RasterizerOpenGL::UploadUniforms(bool accelerate_draw, bool use_gs) {
@@ -2061,15 +2144,36 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw, bool use_gs) {
     state.draw.uniform_buffer = uniform_buffer.GetHandle();
     state.Apply();
 
-    bool sync_vs = accelerate_draw;
-    bool sync_gs = accelerate_draw && use_gs;
-    bool sync_fs = uniform_block_data.dirty;
+    const auto NeedsUpload = [](const auto& data, const auto& uploaded, bool uploaded_valid) {
+        return !uploaded_valid || std::memcmp(&data, &uploaded, sizeof(data)) != 0;
+    };
+
+    bool sync_vs = false;
+    if (accelerate_draw) {
+        vs_uniforms.uniforms.SetFromRegs(Pica::g_state.regs.vs, Pica::g_state.vs);
+        sync_vs = NeedsUpload(vs_uniforms, uploaded_uniforms.vs, uploaded_uniforms.vs_valid);
+    }
 
-    if (!sync_vs && !sync_gs && !sync_fs)
+    bool sync_gs = false;
+    if (accelerate_draw && use_gs) {
+        gs_uniforms.uniforms.SetFromRegs(Pica::g_state.regs.gs, Pica::g_state.gs);
+        sync_gs = NeedsUpload(gs_uniforms, uploaded_uniforms.gs, uploaded_uniforms.gs_valid);
+    }
+
+    const bool sync_fs =
+        uniform_block_data.dirty &&
+        NeedsUpload(uniform_block_data.data, uploaded_uniforms.fs, uploaded_uniforms.fs_valid);
+    const bool sync_uber = uber_uniform_block_data.dirty &&
+                           NeedsUpload(uber_uniform_block_data.data, uploaded_uniforms.uber,
+                                       uploaded_uniforms.uber_valid);
+    uniform_block_data.dirty = false;
+    uber_uniform_block_data.dirty = false;
+
+    if (!sync_vs && !sync_gs && !sync_fs && !sync_uber)
         return;
 
-    std::size_t uniform_size =
-        uniform_size_aligned_vs + uniform_size_aligned_gs + uniform_size_aligned_fs;
+    std::size_t uniform_size = uniform_size_aligned_vs + uniform_size_aligned_gs +
+                               uniform_size_aligned_fs + uniform_size_aligned_uber;
     std::size_t used_bytes = 0;
     u8* uniforms;
     GLintptr offset;
@@ -2077,30 +2181,54 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw, bool use_gs) {
     std::tie(uniforms, offset, invalidate) =
         uniform_buffer.Map(uniform_size, uniform_buffer_alignment);
 
-    if (sync_vs) {
-        VSUniformData vs_uniforms;
-        vs_uniforms.uniforms.SetFromRegs(Pica::g_state.regs.vs, Pica::g_state.vs);
+    // The blocks bound to previous ranges of the buffer are lost when it is invalidated
+    if (invalidate) {
+        uploaded_uniforms.vs_valid = false;
+        uploaded_uniforms.gs_valid = false;
+        uploaded_uniforms.fs_valid = false;
+        uploaded_uniforms.uber_valid = false;
+    }
+
+    if (sync_vs || (invalidate && accelerate_draw)) {
         std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
         glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::VS),
                           uniform_buffer.GetHandle(), offset + used_bytes, sizeof(VSUniformData));
+        uploaded_uniforms.vs = vs_uniforms;
+        uploaded_uniforms.vs_valid = true;
         used_bytes += uniform_size_aligned_vs;
+        MICROPROFILE_META_CPU("OpenGL Uniform Block Uploads", 1);
     }
 
-    if (sync_gs) {
-        GSUniformData gs_uniforms;
-        gs_uniforms.uniforms.SetFromRegs(Pica::g_state.regs.gs, Pica::g_state.gs);
+    if (sync_gs || (invalidate && accelerate_draw && use_gs)) {
         std::memcpy(uniforms + used_bytes, &gs_uniforms, sizeof(gs_uniforms));
         glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::GS),
                           uniform_buffer.GetHandle(), offset + used_bytes, sizeof(GSUniformData));
+        uploaded_uniforms.gs = gs_uniforms;
+        uploaded_uniforms.gs_valid = true;
         used_bytes += uniform_size_aligned_gs;
+        MICROPROFILE_META_CPU("OpenGL Uniform Block Uploads", 1);
     }
 
     if (sync_fs || invalidate) {
         std::memcpy(uniforms + used_bytes, &uniform_block_data.data, sizeof(UniformData));
         glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::Common),
                           uniform_buffer.GetHandle(), offset + used_bytes, sizeof(UniformData));
-        uniform_block_data.dirty = false;
+        uploaded_uniforms.fs = uniform_block_data.data;
+        uploaded_uniforms.fs_valid = true;
         used_bytes += uniform_size_aligned_fs;
+        MICROPROFILE_META_CPU("OpenGL Uniform Block Uploads", 1);
+    }
+
+    if (sync_uber || (invalidate && shader_program_manager->IsUsingUberShader())) {
+        std::memcpy(uniforms + used_bytes, &uber_uniform_block_data.data,
+                    sizeof(UberShaderUniformData));
+        glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::Uber),
+                          uniform_buffer.GetHandle(), offset + used_bytes,
+                          sizeof(UberShaderUniformData));
+        uploaded_uniforms.uber = uber_uniform_block_data.data;
+        uploaded_uniforms.uber_valid = true;
+        used_bytes += uniform_size_aligned_uber;
+        MICROPROFILE_META_CPU("OpenGL Uniform Block Uploads", 1);
     }
 
     uniform_buffer.Unmap(used_bytes);
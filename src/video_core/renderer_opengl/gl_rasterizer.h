@@ -41,6 +41,8 @@ public:
     void AddTriangle(const Pica::Shader::OutputVertex& v0, const Pica::Shader::OutputVertex& v1,
                      const Pica::Shader::OutputVertex& v2) override;
     void DrawTriangles() override;
+    void FlushTriangles() override;
+    void NotifyPicaRegisterWrite(u32 id, u32 value) override;
     void NotifyPicaRegisterChanged(u32 id) override;
     void FlushAll() override;
     void FlushRegion(PAddr addr, u32 size) override;
@@ -219,7 +221,7 @@ private:
     /// Upload the uniform blocks to the uniform buffer object
     void UploadUniforms(bool accelerate_draw, bool use_gs);
 
-    /// Generic draw function for DrawTriangles and AccelerateDrawBatch
+    /// Generic draw function for FlushTriangles and AccelerateDrawBatch
     bool Draw(bool accelerate, bool is_indexed);
 
     /// Internal implementation for AccelerateDrawBatch
@@ -253,6 +255,8 @@ private:
     EmuWindow& emu_window;
 
     std::vector<HardwareVertex> vertex_batch;
+    /// Number of batches merged into vertex_batch since it was last drawn
+    u32 vertex_batch_count = 0;
 
     bool shader_dirty;
 
@@ -269,6 +273,27 @@ private:
         bool dirty;
     } uniform_block_data = {};
 
+    struct {
+        UberShaderUniformData data;
+        bool dirty;
+    } uber_uniform_block_data = {};
+
+    VSUniformData vs_uniforms = {};
+    GSUniformData gs_uniforms = {};
+
+    /// Copies of the uniform blocks last written to the uniform buffer. Games rewrite most of the
+    /// PICA registers with the same values between draws, so blocks matching them are not uploaded
+    struct {
+        VSUniformData vs;
+        GSUniformData gs;
+        UniformData fs;
+        UberShaderUniformData uber;
+        bool vs_valid;
+        bool gs_valid;
+        bool fs_valid;
+        bool uber_valid;
+    } uploaded_uniforms = {};
+
     std::unique_ptr<ShaderProgramManager> shader_program_manager;
 
     // They shall be big enough for about one frame.
@@ -277,6 +302,10 @@ private:
     static constexpr std::size_t UNIFORM_BUFFER_SIZE = 2 * 1024 * 1024;
     static constexpr std::size_t TEXTURE_BUFFER_SIZE = 1 * 1024 * 1024;
 
+    /// Number of software shaded vertices that fit in the vertex buffer, drawn at most per call
+    static constexpr std::size_t MAX_MERGED_VERTICES =
+        3 * (VERTEX_BUFFER_SIZE / (3 * sizeof(HardwareVertex)));
+
     OGLVertexArray sw_vao; // VAO for software shader draw
     OGLVertexArray hw_vao; // VAO for hardware shader / accelerate draw
     std::array<bool, 16> hw_vao_enabled_attributes{};
@@ -291,6 +320,7 @@ private:
     std::size_t uniform_size_aligned_vs;
     std::size_t uniform_size_aligned_gs;
     std::size_t uniform_size_aligned_fs;
+    std::size_t uniform_size_aligned_uber;
 
     SamplerInfo texture_cube_sampler;
 
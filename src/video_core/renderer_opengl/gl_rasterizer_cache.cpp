@@ -9,6 +9,7 @@
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -17,11 +18,13 @@
 #include "common/alignment.h"
 #include "common/bit_field.h"
 #include "common/color.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/vector_math.h"
+#include "common/worker_pool.h"
 #include "core/frontend/emu_window.h"
 #include "core/memory.h"
 #include "core/settings.h"
@@ -71,6 +74,9 @@ static const FormatTuple& GetFormatTuple(PixelFormat pixel_format) {
     return tex_tuple;
 }
 
+/// Host memory that cached surfaces may use before the least recently used ones are removed
+constexpr std::size_t SURFACE_CACHE_BUDGET = 512 * 1024 * 1024;
+
 template <typename Map, typename Interval>
 constexpr auto RangeFromInterval(Map& map, const Interval& interval) {
     return boost::make_iterator_range(map.equal_range(interval));
@@ -86,8 +92,13 @@ template <bool morton_to_gl, PixelFormat format>
 static void MortonCopyTile(u32 stride, u8* tile_buffer, u8* gl_buffer) {
     constexpr u32 bytes_per_pixel = SurfaceParams::GetFormatBpp(format) / 8;
     constexpr u32 gl_bytes_per_pixel = CachedSurface::GetGLBytesPerPixel(format);
+    // Horizontally adjacent pixel pairs are also adjacent in morton order, so they can be copied
+    // together as long as no per-pixel conversion or padding is needed
+    constexpr bool copy_pairs =
+        format != PixelFormat::D24S8 && bytes_per_pixel == gl_bytes_per_pixel;
+    constexpr u32 pixels_per_copy = copy_pairs ? 2 : 1;
     for (u32 y = 0; y < 8; ++y) {
-        for (u32 x = 0; x < 8; ++x) {
+        for (u32 x = 0; x < 8; x += pixels_per_copy) {
             u8* tile_ptr = tile_buffer + VideoCore::MortonInterleave(x, y) * bytes_per_pixel;
             u8* gl_ptr = gl_buffer + ((7 - y) * stride + x) * gl_bytes_per_pixel;
             if (morton_to_gl) {
@@ -95,20 +106,33 @@ static void MortonCopyTile(u32 stride, u8* tile_buffer, u8* gl_buffer) {
                     gl_ptr[0] = tile_ptr[3];
                     std::memcpy(gl_ptr + 1, tile_ptr, 3);
                 } else {
-                    std::memcpy(gl_ptr, tile_ptr, bytes_per_pixel);
+                    std::memcpy(gl_ptr, tile_ptr, bytes_per_pixel * pixels_per_copy);
                 }
             } else {
                 if (format == PixelFormat::D24S8) {
                     std::memcpy(tile_ptr, gl_ptr + 1, 3);
                     tile_ptr[3] = gl_ptr[0];
                 } else {
-                    std::memcpy(tile_ptr, gl_ptr, bytes_per_pixel);
+                    std::memcpy(tile_ptr, gl_ptr, bytes_per_pixel * pixels_per_copy);
                 }
             }
         }
     }
 }
 
+/// Surfaces with at least this many bytes of whole tiles are swizzled on multiple threads
+constexpr u32 MORTON_COPY_PARALLEL_THRESHOLD = 256 * 1024;
+/// Maximum number of threads a single MortonCopy call is split across
+constexpr u32 MORTON_COPY_MAX_THREADS = 4;
+
+/// Threads swizzling large surfaces, started on first use
+static Common::WorkerPool& GetMortonCopyWorkers() {
+    static Common::WorkerPool workers(
+        "MortonCopy",
+        std::clamp(std::thread::hardware_concurrency(), 1u, MORTON_COPY_MAX_THREADS) - 1);
+    return workers;
+}
+
 template <bool morton_to_gl, PixelFormat format>
 static void MortonCopy(u32 stride, u32 height, u8* gl_buffer, PAddr base, PAddr start, PAddr end) {
     constexpr u32 bytes_per_pixel = SurfaceParams::GetFormatBpp(format) / 8;
@@ -124,44 +148,54 @@ static void MortonCopy(u32 stride, u32 height, u8* gl_buffer, PAddr base, PAddr
 
     ASSERT(!morton_to_gl || (aligned_start == start && aligned_end == end));
 
-    const u32 begin_pixel_index = (aligned_down_start - base) / bytes_per_pixel;
-    u32 x = (begin_pixel_index % (stride * 8)) / 8;
-    u32 y = (begin_pixel_index / (stride * 8)) * 8;
-
-    gl_buffer += ((height - 8 - y) * stride + x) * gl_bytes_per_pixel;
-
-    auto glbuf_next_tile = [&] {
-        x = (x + 8) % stride;
-        gl_buffer += 8 * gl_bytes_per_pixel;
-        if (!x) {
-            y += 8;
-            gl_buffer -= stride * 9 * gl_bytes_per_pixel;
-        }
+    // Returns the position in gl_buffer of the bottom left pixel of the tile at the given address
+    auto glbuf_tile = [&](PAddr tile_addr) {
+        const u32 pixel_index = (tile_addr - base) / bytes_per_pixel;
+        const u32 x = (pixel_index % (stride * 8)) / 8;
+        const u32 y = (pixel_index / (stride * 8)) * 8;
+        return gl_buffer + ((height - 8 - y) * stride + x) * gl_bytes_per_pixel;
     };
 
-    u8* tile_buffer = Memory::GetPhysicalPointer(start);
+    u8* const tile_buffer = Memory::GetPhysicalPointer(start);
 
     if (start < aligned_start && !morton_to_gl) {
         std::array<u8, tile_size> tmp_buf;
-        MortonCopyTile<morton_to_gl, format>(stride, &tmp_buf[0], gl_buffer);
+        MortonCopyTile<morton_to_gl, format>(stride, &tmp_buf[0], glbuf_tile(aligned_down_start));
         std::memcpy(tile_buffer, &tmp_buf[start - aligned_down_start],
                     std::min(aligned_start, end) - start);
-
-        tile_buffer += aligned_start - start;
-        glbuf_next_tile();
     }
 
-    const u8* const buffer_end = tile_buffer + aligned_end - aligned_start;
-    while (tile_buffer < buffer_end) {
-        MortonCopyTile<morton_to_gl, format>(stride, tile_buffer, gl_buffer);
-        tile_buffer += tile_size;
-        glbuf_next_tile();
+    // Copies the whole tiles in [first_tile, last_tile) of the aligned region
+    auto copy_tiles = [&](u32 first_tile, u32 last_tile) {
+        PAddr tile_addr = aligned_start + first_tile * tile_size;
+        u8* tile_ptr = tile_buffer + (aligned_start - start) + first_tile * tile_size;
+        for (u32 tile = first_tile; tile < last_tile; ++tile) {
+            MortonCopyTile<morton_to_gl, format>(stride, tile_ptr, glbuf_tile(tile_addr));
+            tile_addr += tile_size;
+            tile_ptr += tile_size;
+        }
+    };
+
+    const u32 num_tiles =
+        aligned_end > aligned_start ? (aligned_end - aligned_start) / tile_size : 0;
+    if (num_tiles * tile_size < MORTON_COPY_PARALLEL_THRESHOLD) {
+        copy_tiles(0, num_tiles);
+    } else {
+        // Every worker writes a disjoint set of tiles, and therefore of gl_buffer rows
+        Common::WorkerPool& workers = GetMortonCopyWorkers();
+        const u32 num_threads = workers.NumThreads();
+        const u32 tiles_per_thread = (num_tiles + num_threads - 1) / num_threads;
+        const u32 num_chunks = (num_tiles + tiles_per_thread - 1) / tiles_per_thread;
+        workers.ParallelFor(num_chunks, [&](std::size_t chunk) {
+            const u32 first_tile = static_cast<u32>(chunk) * tiles_per_thread;
+            copy_tiles(first_tile, std::min(first_tile + tiles_per_thread, num_tiles));
+        });
     }
 
     if (end > std::max(aligned_start, aligned_end) && !morton_to_gl) {
         std::array<u8, tile_size> tmp_buf;
-        MortonCopyTile<morton_to_gl, format>(stride, &tmp_buf[0], gl_buffer);
-        std::memcpy(tile_buffer, &tmp_buf[0], end - aligned_end);
+        MortonCopyTile<morton_to_gl, format>(stride, &tmp_buf[0], glbuf_tile(aligned_end));
+        std::memcpy(tile_buffer + (aligned_end - start), &tmp_buf[0], end - aligned_end);
     }
 }
 
@@ -615,6 +649,7 @@ void RasterizerCacheOpenGL::CopySurface(const Surface& src_surface, const Surfac
         return;
     }
     if (src_surface->CanSubRect(subrect_params)) {
+        dst_surface->InvalidateAllWatcher();
         BlitTextures(src_surface->texture.handle, src_surface->GetScaledSubRect(subrect_params),
                      dst_surface->texture.handle, dst_surface->GetScaledSubRect(subrect_params),
                      src_surface->type, read_framebuffer.handle, draw_framebuffer.handle);
@@ -665,12 +700,17 @@ void CachedSurface::LoadGLBuffer(PAddr load_start, PAddr load_end) {
             const auto rect = GetSubRect(FromInterval(load_interval));
             ASSERT(FromInterval(load_interval).GetInterval() == load_interval);
 
-            for (unsigned y = rect.bottom; y < rect.top; ++y) {
-                for (unsigned x = rect.left; x < rect.right; ++x) {
-                    auto vec4 =
-                        Pica::Texture::LookupTexture(texture_src_data, x, height - 1 - y, tex_info);
-                    const std::size_t offset = (x + (width * y)) * 4;
-                    std::memcpy(&gl_buffer[offset], vec4.AsArray(), 4);
+            // Decode whole tiles at a time. Textures are stored top to bottom in 3DS memory while
+            // gl_buffer is bottom to top, so every tile is written upside down.
+            const std::size_t tile_size = Pica::Texture::CalculateTileSize(tex_info.format);
+            const ptrdiff_t gl_row_size = static_cast<ptrdiff_t>(width) * 4;
+            for (unsigned tex_y = height - rect.top; tex_y < height - rect.bottom; tex_y += 8) {
+                const u8* tile = texture_src_data + (tex_y / 8) * tex_info.stride +
+                                 (rect.left / 8) * tile_size;
+                for (unsigned x = rect.left; x < rect.right; x += 8) {
+                    const std::size_t offset = (x + (width * (height - 1 - tex_y))) * 4;
+                    Pica::Texture::DecodeTile(tile, tex_info, &gl_buffer[offset], -gl_row_size);
+                    tile += tile_size;
                 }
             }
         } else {
@@ -727,7 +767,7 @@ void CachedSurface::FlushGLBuffer(PAddr flush_start, PAddr flush_end) {
 
 MICROPROFILE_DEFINE(OpenGL_TextureUL, "OpenGL", "Texture Upload", MP_RGB(128, 64, 192));
 void CachedSurface::UploadGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint read_fb_handle,
-                                    GLuint draw_fb_handle) {
+                                    GLuint draw_fb_handle, OGLStreamBuffer& upload_buffer) {
     if (type == SurfaceType::Fill)
         return;
 
@@ -765,10 +805,33 @@ void CachedSurface::UploadGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint
     ASSERT(stride * GetGLBytesPerPixel(pixel_format) % 4 == 0);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(stride));
 
+    MICROPROFILE_META_CPU("Surface Upload Bytes",
+                          rect.GetWidth() * rect.GetHeight() * GetGLBytesPerPixel(pixel_format));
+
+    // The rows are staged together with the stride padding between them
+    const std::size_t upload_size =
+        ((rect.GetHeight() - 1) * stride + rect.GetWidth()) * GetGLBytesPerPixel(pixel_format);
+
     glActiveTexture(GL_TEXTURE0);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, static_cast<GLsizei>(rect.GetWidth()),
-                    static_cast<GLsizei>(rect.GetHeight()), tuple.format, tuple.type,
-                    &gl_buffer[buffer_offset]);
+    if (upload_size <= static_cast<std::size_t>(upload_buffer.GetSize())) {
+        // Staging the pixels in the upload buffer lets the driver copy them to the texture
+        // asynchronously instead of reading them from client memory during the call
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload_buffer.GetHandle());
+        u8* staging;
+        GLintptr staging_offset;
+        std::tie(staging, staging_offset, std::ignore) = upload_buffer.Map(upload_size, 4);
+        std::memcpy(staging, &gl_buffer[buffer_offset], upload_size);
+        upload_buffer.Unmap(upload_size);
+
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, static_cast<GLsizei>(rect.GetWidth()),
+                        static_cast<GLsizei>(rect.GetHeight()), tuple.format, tuple.type,
+                        reinterpret_cast<const void*>(staging_offset));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, static_cast<GLsizei>(rect.GetWidth()),
+                        static_cast<GLsizei>(rect.GetHeight()), tuple.format, tuple.type,
+                        &gl_buffer[buffer_offset]);
+    }
 
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
@@ -789,6 +852,69 @@ void CachedSurface::UploadGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint
     InvalidateAllWatcher();
 }
 
+bool CachedSurface::DecodeGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint read_fb_handle,
+                                    GLuint draw_fb_handle, ComputeTextureDecoder& decoder) {
+    ASSERT(type == SurfaceType::Texture);
+
+    const u8* const texture_src_data = Memory::GetPhysicalPointer(addr);
+    if (texture_src_data == nullptr)
+        return false;
+
+    // Surfaces crossing the VRAM bounds are not contiguous in host memory
+    if ((addr < Memory::VRAM_PADDR_END && end > Memory::VRAM_PADDR_END) ||
+        (addr < Memory::VRAM_PADDR && end > Memory::VRAM_PADDR)) {
+        return false;
+    }
+
+    Pica::Texture::TextureInfo tex_info{};
+    tex_info.width = width;
+    tex_info.height = height;
+    tex_info.format = static_cast<Pica::TexturingRegs::TextureFormat>(pixel_format);
+    tex_info.SetDefaultStride();
+    tex_info.physical_address = addr;
+
+    if (res_scale == 1) {
+        if (!decoder.Decode(tex_info, texture_src_data, rect, texture.handle,
+                            static_cast<GLint>(rect.left), static_cast<GLint>(rect.bottom))) {
+            return false;
+        }
+    } else {
+        // Decode into a 1x texture and blit it to the scaled surface, as done for uploads
+        OGLTexture unscaled_tex;
+        unscaled_tex.Create();
+        AllocateSurfaceTexture(unscaled_tex.handle, GetFormatTuple(pixel_format), rect.GetWidth(),
+                               rect.GetHeight());
+        if (!decoder.Decode(tex_info, texture_src_data, rect, unscaled_tex.handle, 0, 0))
+            return false;
+
+        auto scaled_rect = rect;
+        scaled_rect.left *= res_scale;
+        scaled_rect.top *= res_scale;
+        scaled_rect.right *= res_scale;
+        scaled_rect.bottom *= res_scale;
+
+        BlitTextures(unscaled_tex.handle, {0, rect.GetHeight(), rect.GetWidth(), 0},
+                     texture.handle, scaled_rect, type, read_fb_handle, draw_fb_handle);
+    }
+
+    InvalidateAllWatcher();
+    return true;
+}
+
+std::optional<u64> CachedSurface::ComputeContentHash() const {
+    const u8* const texture_src_data = Memory::GetPhysicalPointer(addr);
+    if (texture_src_data == nullptr)
+        return {};
+
+    // Surfaces crossing the VRAM bounds are not contiguous in host memory
+    if ((addr < Memory::VRAM_PADDR_END && end > Memory::VRAM_PADDR_END) ||
+        (addr < Memory::VRAM_PADDR && end > Memory::VRAM_PADDR)) {
+        return {};
+    }
+
+    return Common::ComputeHash64(texture_src_data, size);
+}
+
 MICROPROFILE_DEFINE(OpenGL_TextureDL, "OpenGL", "Texture Download", MP_RGB(128, 192, 64));
 void CachedSurface::DownloadGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint read_fb_handle,
                                       GLuint draw_fb_handle) {
@@ -802,6 +928,19 @@ void CachedSurface::DownloadGLTexture(const MathUtil::Rectangle<u32>& rect, GLui
         gl_buffer.reset(new u8[gl_buffer_size]);
     }
 
+    if (ReadAsyncDownload(rect))
+        return;
+
+    // No prefetched data, the CPU is reading this surface so try to prefetch it next time
+    cpu_read_hint = true;
+
+    std::size_t buffer_offset =
+        (rect.bottom * stride + rect.left) * GetGLBytesPerPixel(pixel_format);
+    ReadGLTexture(rect, read_fb_handle, draw_fb_handle, &gl_buffer[buffer_offset]);
+}
+
+void CachedSurface::ReadGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint read_fb_handle,
+                                  GLuint draw_fb_handle, void* pixels) {
     OpenGLState state = OpenGLState::GetCurState();
     OpenGLState prev_state = state;
     SCOPE_EXIT({ prev_state.Apply(); });
@@ -811,8 +950,6 @@ void CachedSurface::DownloadGLTexture(const MathUtil::Rectangle<u32>& rect, GLui
     // Ensure no bad interactions with GL_PACK_ALIGNMENT
     ASSERT(stride * GetGLBytesPerPixel(pixel_format) % 4 == 0);
     glPixelStorei(GL_PACK_ROW_LENGTH, static_cast<GLint>(stride));
-    std::size_t buffer_offset =
-        (rect.bottom * stride + rect.left) * GetGLBytesPerPixel(pixel_format);
 
     // If not 1x scale, blit scaled texture to a new 1x texture and use that to flush
     if (res_scale != 1) {
@@ -834,7 +971,7 @@ void CachedSurface::DownloadGLTexture(const MathUtil::Rectangle<u32>& rect, GLui
         state.Apply();
 
         glActiveTexture(GL_TEXTURE0);
-        glGetTexImage(GL_TEXTURE_2D, 0, tuple.format, tuple.type, &gl_buffer[buffer_offset]);
+        glGetTexImage(GL_TEXTURE_2D, 0, tuple.format, tuple.type, pixels);
     } else {
         state.ResetTexture(texture.handle);
         state.draw.read_framebuffer = read_fb_handle;
@@ -857,12 +994,91 @@ void CachedSurface::DownloadGLTexture(const MathUtil::Rectangle<u32>& rect, GLui
         }
         glReadPixels(static_cast<GLint>(rect.left), static_cast<GLint>(rect.bottom),
                      static_cast<GLsizei>(rect.GetWidth()), static_cast<GLsizei>(rect.GetHeight()),
-                     tuple.format, tuple.type, &gl_buffer[buffer_offset]);
+                     tuple.format, tuple.type, pixels);
     }
 
     glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 }
 
+MICROPROFILE_DEFINE(OpenGL_AsyncDL, "OpenGL", "Async Texture Download", MP_RGB(128, 192, 128));
+void CachedSurface::StartAsyncDownload(GLuint read_fb_handle, GLuint draw_fb_handle) {
+    if (type == SurfaceType::Fill || download_pending)
+        return;
+
+    MICROPROFILE_SCOPE(OpenGL_AsyncDL);
+
+    if (download_buffer.handle == 0) {
+        download_buffer.Create();
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, download_buffer.handle);
+        glBufferData(GL_PIXEL_PACK_BUFFER, width * height * GetGLBytesPerPixel(pixel_format),
+                     nullptr, GL_STREAM_READ);
+    } else {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, download_buffer.handle);
+    }
+
+    // The buffer has the same layout as gl_buffer, so the whole surface starts at offset 0
+    ReadGLTexture(GetRect(), read_fb_handle, draw_fb_handle, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    download_fence.Create();
+    download_pending = true;
+    download_used = false;
+}
+
+void CachedSurface::DiscardAsyncDownload() {
+    if (!download_pending)
+        return;
+
+    // Stop prefetching if the CPU did not read the data this time
+    if (!download_used)
+        cpu_read_hint = false;
+
+    download_fence.Release();
+    download_pending = false;
+    download_used = false;
+}
+
+bool CachedSurface::ReadAsyncDownload(const MathUtil::Rectangle<u32>& rect) {
+    if (!download_pending)
+        return false;
+
+    MICROPROFILE_SCOPE(OpenGL_AsyncDL);
+
+    if (download_fence.handle != nullptr) {
+        // Only block here, when the CPU actually needs the data
+        GLenum result;
+        do {
+            result = glClientWaitSync(download_fence.handle, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                      1000000000); // 1 second
+        } while (result == GL_TIMEOUT_EXPIRED);
+        download_fence.Release();
+    }
+
+    const u32 bytes_per_pixel = GetGLBytesPerPixel(pixel_format);
+    const std::size_t row_size = rect.GetWidth() * bytes_per_pixel;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, download_buffer.handle);
+    const u8* mapped = static_cast<const u8*>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, gl_buffer_size, GL_MAP_READ_BIT));
+    if (mapped != nullptr) {
+        for (u32 y = rect.bottom; y < rect.top; ++y) {
+            const std::size_t offset = (y * stride + rect.left) * bytes_per_pixel;
+            std::memcpy(&gl_buffer[offset], mapped + offset, row_size);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (mapped == nullptr) {
+        LOG_ERROR(Render_OpenGL, "Failed to map surface download buffer");
+        DiscardAsyncDownload();
+        return false;
+    }
+
+    download_used = true;
+    return true;
+}
+
 enum MatchFlags {
     Invalid = 1,      // Flag that can be applied to other match types, invalid matches require
                       // validation before they can be used
@@ -966,7 +1182,16 @@ Surface FindMatch(const SurfaceCache& surface_cache, const SurfaceParams& params
     return match_surface;
 }
 
-RasterizerCacheOpenGL::RasterizerCacheOpenGL() {
+RasterizerCacheOpenGL::RasterizerCacheOpenGL()
+    : texture_upload_buffer(GL_PIXEL_UNPACK_BUFFER, TEXTURE_UPLOAD_BUFFER_SIZE, false) {
+    // The upload buffer must only be bound while uploading, as it changes the meaning of the
+    // pixel pointers of all other texture uploads
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (ComputeTextureDecoder::IsSupported()) {
+        texture_decoder = std::make_unique<ComputeTextureDecoder>();
+    }
+
     read_framebuffer.Create();
     draw_framebuffer.Create();
 
@@ -1106,10 +1331,21 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
     ASSERT(!params.is_tiled || (params.width % 8 == 0 && params.height % 8 == 0));
 
     // Check for an exact match in existing surfaces
-    Surface surface =
-        FindMatch<MatchFlags::Exact | MatchFlags::Invalid>(surface_cache, params, match_res_scale);
-
+    Surface surface = LookupMatchCache(params, match_res_scale);
     if (surface == nullptr) {
+        surface = FindMatch<MatchFlags::Exact | MatchFlags::Invalid>(surface_cache, params,
+                                                                     match_res_scale);
+        // The search prefers valid surfaces, so only remember the result if it is valid. As long
+        // as it stays valid and no surfaces are added or removed, the search gives the same result
+        if (surface != nullptr && surface->IsRegionValid(params.GetInterval())) {
+            InsertMatchCache(params, match_res_scale, surface);
+        }
+    }
+
+    if (surface != nullptr) {
+        MICROPROFILE_META_CPU("Surface Cache Hits", 1);
+    } else {
+        MICROPROFILE_META_CPU("Surface Cache Misses", 1);
         u16 target_res_scale = params.res_scale;
         if (match_res_scale != ScaleMatch::Exact) {
             // This surface may have a subrect of another surface with a higher res_scale, find it
@@ -1136,6 +1372,8 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
         RegisterSurface(surface);
     }
 
+    TouchSurface(surface);
+
     if (load_if_create) {
         ValidateSurface(surface, params.addr, params.size);
     }
@@ -1215,8 +1453,12 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
         new_params.UpdateParams();
         // GetSurface will create the new surface and possibly adjust res_scale if necessary
         surface = GetSurface(new_params, match_res_scale, load_if_create);
-    } else if (load_if_create) {
-        ValidateSurface(surface, aligned_params.addr, aligned_params.size);
+    } else {
+        MICROPROFILE_META_CPU("Surface Cache Hits", 1);
+        TouchSurface(surface);
+        if (load_if_create) {
+            ValidateSurface(surface, aligned_params.addr, aligned_params.size);
+        }
     }
 
     return std::make_tuple(surface, surface->GetScaledSubRect(params));
@@ -1361,6 +1603,11 @@ SurfaceSurfaceRect_Tuple RasterizerCacheOpenGL::GetFramebufferSurfaces(
         texture_cube_cache.clear();
     }
 
+    // No surfaces are in use at the start of a draw, so this is a safe point to free some
+    if (registered_size > SURFACE_CACHE_BUDGET) {
+        EvictSurfaces();
+    }
+
     MathUtil::Rectangle<u32> viewport_clamped{
         static_cast<u32>(std::clamp(viewport_rect.left, 0, static_cast<s32>(config.GetWidth()))),
         static_cast<u32>(std::clamp(viewport_rect.top, 0, static_cast<s32>(config.GetHeight()))),
@@ -1423,6 +1670,16 @@ SurfaceSurfaceRect_Tuple RasterizerCacheOpenGL::GetFramebufferSurfaces(
         fb_rect = depth_rect;
     }
 
+    // Surfaces that are no longer bound are done being rendered to for now
+    if (last_color_surface != color_surface) {
+        PrefetchFramebufferSurface(last_color_surface);
+        last_color_surface = color_surface;
+    }
+    if (last_depth_surface != depth_surface) {
+        PrefetchFramebufferSurface(last_depth_surface);
+        last_depth_surface = depth_surface;
+    }
+
     if (color_surface != nullptr) {
         ValidateSurface(color_surface, boost::icl::first(color_vp_interval),
                         boost::icl::length(color_vp_interval));
@@ -1552,6 +1809,7 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
 
                 ConvertD24S8toABGR(reinterpret_surface->texture.handle, src_rect,
                                    surface->texture.handle, dest_rect);
+                surface->InvalidateAllWatcher();
 
                 surface->invalid_regions.erase(convert_interval);
                 continue;
@@ -1560,9 +1818,30 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
 
         // Load data from 3DS memory
         FlushRegion(params.addr, params.size);
-        surface->LoadGLBuffer(params.addr, params.end);
-        surface->UploadGLTexture(surface->GetSubRect(params), read_framebuffer.handle,
-                                 draw_framebuffer.handle);
+
+        // Whole surfaces are looked up by content first, as titles often load the same texture
+        // again, either to another address or to the same one after invalidating it
+        std::optional<u64> content_hash;
+        if (Settings::values.use_texture_deduplication &&
+            params.GetInterval() == surface->GetInterval()) {
+            content_hash = surface->ComputeContentHash();
+        }
+
+        if (!content_hash || !LoadFromContentPool(surface, *content_hash)) {
+            if (surface->type != SurfaceType::Texture || texture_decoder == nullptr ||
+                !surface->DecodeGLTexture(surface->GetSubRect(params), read_framebuffer.handle,
+                                          draw_framebuffer.handle, *texture_decoder)) {
+                surface->LoadGLBuffer(params.addr, params.end);
+                surface->UploadGLTexture(surface->GetSubRect(params), read_framebuffer.handle,
+                                         draw_framebuffer.handle, texture_upload_buffer);
+            }
+        }
+
+        if (content_hash) {
+            surface->content_hash = *content_hash;
+            surface->content_hash_valid = true;
+            AddToContentPool(surface);
+        }
         surface->invalid_regions.erase(params.GetInterval());
     }
 }
@@ -1599,6 +1878,21 @@ void RasterizerCacheOpenGL::FlushRegion(PAddr addr, u32 size, Surface flush_surf
     dirty_regions -= flushed_intervals;
 }
 
+void RasterizerCacheOpenGL::PrefetchFramebufferSurface(const Surface& surface) {
+    if (surface == nullptr || !surface->registered || !surface->cpu_read_hint)
+        return;
+
+    // Only worth it if the surface still owns data that has not been written back to memory
+    const auto dirty_range = RangeFromInterval(dirty_regions, surface->GetInterval());
+    const bool is_dirty =
+        std::any_of(dirty_range.begin(), dirty_range.end(),
+                    [&surface](const auto& pair) { return pair.second == surface; });
+    if (!is_dirty)
+        return;
+
+    surface->StartAsyncDownload(read_framebuffer.handle, draw_framebuffer.handle);
+}
+
 void RasterizerCacheOpenGL::FlushAll() {
     FlushRegion(0, 0xFFFFFFFF);
 }
@@ -1685,6 +1979,8 @@ void RasterizerCacheOpenGL::RegisterSurface(const Surface& surface) {
     surface->registered = true;
     surface_cache.add({surface->GetInterval(), SurfaceSet{surface}});
     UpdatePagesCachedCount(surface->addr, surface->size, 1);
+    registered_size += surface->GetHostSize();
+    match_cache.fill({});
 }
 
 void RasterizerCacheOpenGL::UnregisterSurface(const Surface& surface) {
@@ -1694,6 +1990,139 @@ void RasterizerCacheOpenGL::UnregisterSurface(const Surface& surface) {
     surface->registered = false;
     UpdatePagesCachedCount(surface->addr, surface->size, -1);
     surface_cache.subtract({surface->GetInterval(), SurfaceSet{surface}});
+    registered_size -= surface->GetHostSize();
+    match_cache.fill({});
+}
+
+void RasterizerCacheOpenGL::TouchSurface(const Surface& surface) {
+    surface->last_used = ++access_tick;
+}
+
+void RasterizerCacheOpenGL::EvictSurfaces() {
+    std::vector<Surface> candidates;
+    for (const auto& pair : surface_cache) {
+        for (const auto& surface : pair.second) {
+            // Fill surfaces don't own a texture, and the bound framebuffers are likely to be
+            // drawn to again soon
+            if (surface->type == SurfaceType::Fill || surface == last_color_surface ||
+                surface == last_depth_surface) {
+                continue;
+            }
+            candidates.push_back(surface);
+        }
+    }
+
+    // A surface spanning multiple intervals appears once for each of them
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    std::sort(candidates.begin(), candidates.end(), [](const Surface& a, const Surface& b) {
+        return a->last_used < b->last_used;
+    });
+
+    // Free some more than necessary so that this doesn't run again on the next draw
+    const std::size_t target_size = SURFACE_CACHE_BUDGET / 4 * 3;
+    std::size_t evicted_size = 0;
+    for (const auto& surface : candidates) {
+        if (registered_size <= target_size)
+            break;
+
+        // Surfaces holding data that has not been written back to memory can't be removed
+        // without flushing them first, which is more expensive than keeping them
+        const auto dirty_range = RangeFromInterval(dirty_regions, surface->GetInterval());
+        if (std::any_of(dirty_range.begin(), dirty_range.end(),
+                        [&surface](const auto& pair) { return pair.second == surface; })) {
+            continue;
+        }
+
+        evicted_size += surface->GetHostSize();
+        UnregisterSurface(surface);
+    }
+
+    LOG_DEBUG(Render_OpenGL, "Evicted {} KiB of surfaces, {} KiB remaining", evicted_size / 1024,
+              registered_size / 1024);
+}
+
+Surface RasterizerCacheOpenGL::LookupMatchCache(const SurfaceParams& params,
+                                                ScaleMatch match_res_scale) const {
+    for (const auto& entry : match_cache) {
+        if (entry.surface == nullptr || entry.match_res_scale != match_res_scale ||
+            entry.params.res_scale != params.res_scale || !entry.params.ExactMatch(params)) {
+            continue;
+        }
+        if (!entry.surface->IsRegionValid(params.GetInterval())) {
+            // A different surface may be preferred now, search again
+            return nullptr;
+        }
+        return entry.surface;
+    }
+    return nullptr;
+}
+
+void RasterizerCacheOpenGL::InsertMatchCache(const SurfaceParams& params,
+                                             ScaleMatch match_res_scale, const Surface& surface) {
+    match_cache[match_cache_next] = {params, match_res_scale, surface};
+    match_cache_next = (match_cache_next + 1) % match_cache.size();
+}
+
+static std::size_t GetContentPoolKey(const SurfaceParams& params, u64 content_hash) {
+    std::size_t key = 0;
+    boost::hash_combine(key, content_hash);
+    boost::hash_combine(key, static_cast<u32>(params.pixel_format));
+    boost::hash_combine(key, params.width);
+    boost::hash_combine(key, params.height);
+    boost::hash_combine(key, params.stride);
+    boost::hash_combine(key, params.is_tiled);
+    boost::hash_combine(key, params.res_scale);
+    return key;
+}
+
+bool RasterizerCacheOpenGL::LoadFromContentPool(const Surface& surface, u64 content_hash) {
+    // The memory may have been written again with the data the texture already holds
+    if (!surface->content_hash_valid || surface->content_hash != content_hash) {
+        const auto it = content_pool.find(GetContentPoolKey(*surface, content_hash));
+        if (it == content_pool.end())
+            return false;
+
+        const Surface source = it->second.lock();
+        if (source == nullptr || !source->content_hash_valid ||
+            source->content_hash != content_hash) {
+            content_pool.erase(it);
+            return false;
+        }
+
+        // Different layouts may still collide on the key
+        if (source->pixel_format != surface->pixel_format || source->width != surface->width ||
+            source->height != surface->height || source->stride != surface->stride ||
+            source->is_tiled != surface->is_tiled || source->res_scale != surface->res_scale) {
+            return false;
+        }
+
+        if (!BlitSurfaces(source, source->GetScaledRect(), surface, surface->GetScaledRect()))
+            return false;
+    }
+
+    MICROPROFILE_META_CPU("Texture Dedup Hits", 1);
+    MICROPROFILE_META_CPU("Texture Dedup Saved Bytes",
+                          surface->width * surface->height *
+                              CachedSurface::GetGLBytesPerPixel(surface->pixel_format));
+    return true;
+}
+
+void RasterizerCacheOpenGL::AddToContentPool(const Surface& surface) {
+    if (content_pool.size() >= CONTENT_POOL_SWEEP_SIZE) {
+        // Drop the entries of surfaces that were destroyed or whose texture changed since
+        for (auto it = content_pool.begin(); it != content_pool.end();) {
+            const Surface pooled = it->second.lock();
+            if (pooled == nullptr || !pooled->content_hash_valid ||
+                GetContentPoolKey(*pooled, pooled->content_hash) != it->first) {
+                it = content_pool.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    content_pool[GetContentPoolKey(*surface, surface->content_hash)] = surface;
 }
 
 void RasterizerCacheOpenGL::UpdatePagesCachedCount(PAddr addr, u32 size, int delta) {
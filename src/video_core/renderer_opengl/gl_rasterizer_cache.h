@@ -7,6 +7,7 @@
 #include <array>
 #include <list>
 #include <memory>
+#include <optional>
 #include <set>
 #include <tuple>
 #ifdef __GNUC__
@@ -29,6 +30,8 @@
 #include "video_core/regs_framebuffer.h"
 #include "video_core/regs_texturing.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
+#include "video_core/renderer_opengl/gl_stream_buffer.h"
+#include "video_core/renderer_opengl/gl_texture_decoder.h"
 #include "video_core/texture/texture_decode.h"
 
 struct CachedSurface;
@@ -306,6 +309,15 @@ struct CachedSurface : SurfaceParams, std::enable_shared_from_this<CachedSurface
     bool registered = false;
     SurfaceRegions invalid_regions;
 
+    /// Value of the cache access counter when this surface was last requested
+    u64 last_used = 0;
+
+    /// Approximate amount of host memory used by the texture of this surface
+    std::size_t GetHostSize() const {
+        return static_cast<std::size_t>(GetScaledWidth()) * GetScaledHeight() *
+               GetGLBytesPerPixel(pixel_format);
+    }
+
     u32 fill_size = 0; /// Number of bytes to read from fill_data
     std::array<u8, 4> fill_data;
 
@@ -329,10 +341,33 @@ struct CachedSurface : SurfaceParams, std::enable_shared_from_this<CachedSurface
 
     // Upload/Download data in gl_buffer in/to this surface's texture
     void UploadGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint read_fb_handle,
-                         GLuint draw_fb_handle);
+                         GLuint draw_fb_handle, OGLStreamBuffer& upload_buffer);
     void DownloadGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint read_fb_handle,
                            GLuint draw_fb_handle);
 
+    /// Decode texture data in 3DS memory into this surface's texture on the GPU, bypassing
+    /// gl_buffer. Returns false if the data has to be loaded through gl_buffer instead
+    bool DecodeGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint read_fb_handle,
+                         GLuint draw_fb_handle, ComputeTextureDecoder& decoder);
+
+    /// Hash of the memory the whole texture was last loaded from. Only valid until the texture
+    /// content is changed in any other way
+    u64 content_hash = 0;
+    bool content_hash_valid = false;
+
+    /// Hashes the 3DS memory backing this surface, returns nothing if it can't be read directly
+    std::optional<u64> ComputeContentHash() const;
+
+    /// Set when the CPU has read back this surface, used to predict future read backs
+    bool cpu_read_hint = false;
+
+    /// Begins an asynchronous download of the whole texture into a pixel pack buffer. A later
+    /// DownloadGLTexture will use its result instead of stalling on a synchronous read.
+    void StartAsyncDownload(GLuint read_fb_handle, GLuint draw_fb_handle);
+
+    /// Drops the pending asynchronous download, called when the texture content changes
+    void DiscardAsyncDownload();
+
     std::shared_ptr<SurfaceWatcher> CreateWatcher() {
         auto watcher = std::make_shared<SurfaceWatcher>(weak_from_this());
         watchers.push_front(watcher);
@@ -340,6 +375,9 @@ struct CachedSurface : SurfaceParams, std::enable_shared_from_this<CachedSurface
     }
 
     void InvalidateAllWatcher() {
+        // The texture content is changing, so any pending download would be stale
+        DiscardAsyncDownload();
+        content_hash_valid = false;
         for (const auto& watcher : watchers) {
             if (auto locked = watcher.lock()) {
                 locked->valid = false;
@@ -348,7 +386,20 @@ struct CachedSurface : SurfaceParams, std::enable_shared_from_this<CachedSurface
     }
 
 private:
+    /// Reads rect of the texture into pixels, which is an offset if a pixel pack buffer is bound
+    void ReadGLTexture(const MathUtil::Rectangle<u32>& rect, GLuint read_fb_handle,
+                       GLuint draw_fb_handle, void* pixels);
+
+    /// Copies rect from a finished asynchronous download to gl_buffer, returns false if there is
+    /// no usable download
+    bool ReadAsyncDownload(const MathUtil::Rectangle<u32>& rect);
+
     std::list<std::weak_ptr<SurfaceWatcher>> watchers;
+
+    OGLBuffer download_buffer;
+    OGLSync download_fence;
+    bool download_pending = false; ///< download_buffer holds the current texture content
+    bool download_used = false;    ///< The pending download has been read by the CPU
 };
 
 struct TextureCubeConfig {
@@ -469,6 +520,29 @@ private:
     /// Increase/decrease the number of surface in pages touching the specified region
     void UpdatePagesCachedCount(PAddr addr, u32 size, int delta);
 
+    /// Marks the surface as most recently used
+    void TouchSurface(const Surface& surface);
+
+    /// Removes the least recently used surfaces that hold no unflushed data until the cached
+    /// surfaces fit into the host memory budget again
+    void EvictSurfaces();
+
+    /// Looks up the result of a recent exact match search, returns nullptr if there is none
+    Surface LookupMatchCache(const SurfaceParams& params, ScaleMatch match_res_scale) const;
+    void InsertMatchCache(const SurfaceParams& params, ScaleMatch match_res_scale,
+                          const Surface& surface);
+
+    /// Copies the texture of a surface loaded from identical memory into surface, returns false if
+    /// there is none
+    bool LoadFromContentPool(const Surface& surface, u64 content_hash);
+
+    /// Makes a surface whose whole texture was just loaded from memory available for reuse
+    void AddToContentPool(const Surface& surface);
+
+    /// Starts an asynchronous download of a framebuffer surface that is no longer being drawn to,
+    /// if the CPU is expected to read it back
+    void PrefetchFramebufferSurface(const Surface& surface);
+
     SurfaceCache surface_cache;
     PageMap cached_pages;
     SurfaceMap dirty_regions;
@@ -477,6 +551,13 @@ private:
     OGLFramebuffer read_framebuffer;
     OGLFramebuffer draw_framebuffer;
 
+    /// Staging memory for texture uploads, large enough for a full 1024x1024 RGBA8 surface
+    static constexpr GLsizeiptr TEXTURE_UPLOAD_BUFFER_SIZE = 8 * 1024 * 1024;
+    OGLStreamBuffer texture_upload_buffer;
+
+    /// Decodes texture-only formats on the GPU when compute shaders are supported
+    std::unique_ptr<ComputeTextureDecoder> texture_decoder;
+
     OGLVertexArray attributeless_vao;
     OGLBuffer d24s8_abgr_buffer;
     GLsizeiptr d24s8_abgr_buffer_size;
@@ -485,4 +566,27 @@ private:
     GLint d24s8_abgr_viewport_u_id;
 
     std::unordered_map<TextureCubeConfig, CachedTextureCube> texture_cube_cache;
+
+    /// Surfaces whose texture holds the unmodified content of the memory they were loaded from,
+    /// keyed by that content and the layout of the surface
+    static constexpr std::size_t CONTENT_POOL_SWEEP_SIZE = 1024;
+    std::unordered_map<std::size_t, std::weak_ptr<CachedSurface>> content_pool;
+
+    Surface last_color_surface;
+    Surface last_depth_surface;
+
+    /// Counter incremented on every surface request, used to find least recently used surfaces
+    u64 access_tick = 0;
+    /// Approximate host memory used by all registered surfaces
+    std::size_t registered_size = 0;
+
+    /// Results of the most recent exact surface lookups. Cleared whenever the set of registered
+    /// surfaces changes, as the result of a search can only change with it.
+    struct MatchCacheEntry {
+        SurfaceParams params;
+        ScaleMatch match_res_scale;
+        Surface surface;
+    };
+    std::array<MatchCacheEntry, 16> match_cache;
+    std::size_t match_cache_next = 0;
 };
@@ -294,3 +294,37 @@ public:
 
     GLuint handle = 0;
 };
+
+class OGLSync : private NonCopyable {
+public:
+    OGLSync() = default;
+
+    OGLSync(OGLSync&& o) : handle(std::exchange(o.handle, nullptr)) {}
+
+    ~OGLSync() {
+        Release();
+    }
+
+    OGLSync& operator=(OGLSync&& o) {
+        Release();
+        handle = std::exchange(o.handle, nullptr);
+        return *this;
+    }
+
+    /// Inserts a new fence into the command stream and stores the handle
+    void Create() {
+        if (handle != nullptr)
+            return;
+        handle = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    /// Deletes the internal OpenGL resource
+    void Release() {
+        if (handle == nullptr)
+            return;
+        glDeleteSync(handle);
+        handle = nullptr;
+    }
+
+    GLsync handle = nullptr;
+};
@@ -0,0 +1,226 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <fmt/format.h>
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "core/settings.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+
+namespace {
+
+constexpr u32 SHADER_CACHE_MAGIC = 0x43445343; // "CSDC"
+constexpr u32 SHADER_CACHE_VERSION = 1;
+
+// Upper bounds used to reject corrupted entries before allocating memory for them
+constexpr u32 MAX_KEY_SIZE = 0x1000;
+constexpr u32 MAX_DATA_SIZE = 0x1000000;
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+    u32 separable;
+    u32 tag_size;
+};
+
+struct EntryHeader {
+    u32 type;
+    u32 key_size;
+    u32 code_size;
+};
+
+struct BinaryHeader {
+    u64 code_hash;
+    u32 format;
+    u32 size;
+};
+
+template <typename T>
+bool ReadObject(FileUtil::IOFile& file, T& object) {
+    return file.ReadArray(&object, 1) == 1;
+}
+
+/// Reads and validates the header of a cache file, leaving the file positioned at the first entry
+bool ReadFileHeader(FileUtil::IOFile& file, bool separable, const std::string& tag) {
+    FileHeader header;
+    if (!ReadObject(file, header) || header.magic != SHADER_CACHE_MAGIC ||
+        header.version != SHADER_CACHE_VERSION || header.separable != (separable ? 1 : 0) ||
+        header.tag_size != tag.size()) {
+        return false;
+    }
+
+    std::string file_tag(header.tag_size, '\0');
+    return file.ReadBytes(file_tag.data(), file_tag.size()) == file_tag.size() && file_tag == tag;
+}
+
+void WriteFileHeader(FileUtil::IOFile& file, bool separable, const std::string& tag) {
+    const FileHeader header{SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, separable ? 1u : 0u,
+                            static_cast<u32>(tag.size())};
+    file.WriteObject(header);
+    file.WriteString(tag);
+}
+
+} // anonymous namespace
+
+ShaderDiskCache::ShaderDiskCache(u64 title_id, bool separable) : separable(separable) {
+    if (!Settings::values.use_disk_shader_cache || title_id == 0)
+        return;
+
+    enabled = true;
+
+    const std::string base_path = fmt::format(
+        "{}shaders/opengl/{:016X}", FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), title_id);
+    entries_path = base_path + ".glsl";
+    binaries_path = base_path + ".bin";
+
+    build_tag = Common::g_scm_rev;
+    driver_tag = fmt::format("{}/{}/{}", reinterpret_cast<const char*>(glGetString(GL_VENDOR)),
+                             reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+                             reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+    // Binaries are only stored for separable programs, as the linked programs of the
+    // non-separable path combine shaders in arbitrary tuples
+    GLint num_binary_formats = 0;
+    if (separable && GLAD_GL_ARB_get_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_binary_formats);
+    }
+    binaries_supported = num_binary_formats > 0;
+}
+
+std::vector<ShaderDiskCacheEntry> ShaderDiskCache::LoadEntries() {
+    std::vector<ShaderDiskCacheEntry> entries;
+    if (!enabled)
+        return entries;
+
+    FileUtil::IOFile file(entries_path, "rb");
+    if (!file.IsOpen())
+        return entries;
+
+    if (!ReadFileHeader(file, separable, build_tag)) {
+        LOG_INFO(Render_OpenGL, "Discarding shader cache written by a different build");
+        file.Close();
+        FileUtil::Delete(entries_path);
+        return entries;
+    }
+    entries_valid_size = file.Tell();
+
+    EntryHeader header;
+    while (ReadObject(file, header)) {
+        if (header.key_size > MAX_KEY_SIZE || header.code_size > MAX_DATA_SIZE) {
+            LOG_ERROR(Render_OpenGL, "Shader cache entry is corrupted, ignoring the rest");
+            break;
+        }
+
+        ShaderDiskCacheEntry entry;
+        entry.type = static_cast<ShaderDiskCacheType>(header.type);
+        entry.key.resize(header.key_size);
+        entry.code.resize(header.code_size);
+        if (file.ReadBytes(entry.key.data(), entry.key.size()) != entry.key.size() ||
+            file.ReadBytes(entry.code.data(), entry.code.size()) != entry.code.size()) {
+            break;
+        }
+
+        entries.push_back(std::move(entry));
+        entries_valid_size = file.Tell();
+    }
+
+    LOG_INFO(Render_OpenGL, "Loaded {} shaders from the disk cache", entries.size());
+    return entries;
+}
+
+std::unordered_map<u64, ShaderDiskCacheBinary> ShaderDiskCache::LoadBinaries() {
+    std::unordered_map<u64, ShaderDiskCacheBinary> binaries;
+    if (!enabled || !binaries_supported)
+        return binaries;
+
+    FileUtil::IOFile file(binaries_path, "rb");
+    if (!file.IsOpen())
+        return binaries;
+
+    if (!ReadFileHeader(file, separable, driver_tag)) {
+        LOG_INFO(Render_OpenGL, "Discarding shader binaries created by a different driver");
+        file.Close();
+        FileUtil::Delete(binaries_path);
+        return binaries;
+    }
+    binaries_valid_size = file.Tell();
+
+    BinaryHeader header;
+    while (ReadObject(file, header)) {
+        if (header.size > MAX_DATA_SIZE) {
+            LOG_ERROR(Render_OpenGL, "Shader binary is corrupted, ignoring the rest");
+            break;
+        }
+
+        ShaderDiskCacheBinary binary;
+        binary.format = static_cast<GLenum>(header.format);
+        binary.data.resize(header.size);
+        if (file.ReadBytes(binary.data.data(), binary.data.size()) != binary.data.size())
+            break;
+
+        binaries[header.code_hash] = std::move(binary);
+        binaries_valid_size = file.Tell();
+    }
+
+    return binaries;
+}
+
+void ShaderDiskCache::SaveEntry(const ShaderDiskCacheEntry& entry) {
+    if (!enabled || !OpenForAppend(entries_file, entries_path, entries_valid_size, build_tag))
+        return;
+
+    const EntryHeader header{static_cast<u32>(entry.type), static_cast<u32>(entry.key.size()),
+                             static_cast<u32>(entry.code.size())};
+    entries_file.WriteObject(header);
+    entries_file.WriteBytes(entry.key.data(), entry.key.size());
+    entries_file.WriteString(entry.code);
+    entries_file.Flush();
+}
+
+void ShaderDiskCache::SaveBinary(const std::string& code, GLuint program) {
+    if (!enabled || !binaries_supported)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    ShaderDiskCacheBinary binary;
+    binary.data.resize(static_cast<std::size_t>(length));
+    glGetProgramBinary(program, length, nullptr, &binary.format, binary.data.data());
+
+    if (!OpenForAppend(binaries_file, binaries_path, binaries_valid_size, driver_tag))
+        return;
+
+    const BinaryHeader header{Common::ComputeHash64(code.data(), code.size()),
+                              static_cast<u32>(binary.format),
+                              static_cast<u32>(binary.data.size())};
+    binaries_file.WriteObject(header);
+    binaries_file.WriteBytes(binary.data.data(), binary.data.size());
+    binaries_file.Flush();
+}
+
+bool ShaderDiskCache::OpenForAppend(FileUtil::IOFile& file, const std::string& path,
+                                    u64 valid_size, const std::string& tag) {
+    if (file.IsOpen())
+        return file.IsGood();
+
+    FileUtil::CreateFullPath(path);
+    if (!file.Open(path, "ab")) {
+        LOG_ERROR(Render_OpenGL, "Failed to open shader cache file {}", path);
+        enabled = false;
+        return false;
+    }
+
+    // Drop an entry that was only partially written, e.g. when the emulator crashed
+    if (file.GetSize() > valid_size)
+        file.Resize(valid_size);
+
+    if (file.GetSize() == 0)
+        WriteFileHeader(file, separable, tag);
+
+    return file.IsGood();
+}
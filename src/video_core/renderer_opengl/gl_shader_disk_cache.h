@@ -0,0 +1,84 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+/// Kind of generated shader stored in the disk shader cache
+enum class ShaderDiskCacheType : u32 {
+    ProgrammableVertex,
+    ProgrammableGeometry,
+    FixedGeometry,
+    Fragment,
+};
+
+/// A generated shader, stored as the raw state of the config it was generated from and its GLSL
+struct ShaderDiskCacheEntry {
+    ShaderDiskCacheType type;
+    std::vector<u8> key;
+    std::string code;
+};
+
+/// A driver specific binary of a linked separable shader program
+struct ShaderDiskCacheBinary {
+    GLenum format;
+    std::vector<u8> data;
+};
+
+/**
+ * Per-title storage for shaders generated by the ShaderProgramManager. The GLSL sources are only
+ * valid for the build that generated them, and are discarded when loaded by any other build. The
+ * program binaries are kept in a separate file which is discarded when the driver changes.
+ */
+class ShaderDiskCache {
+public:
+    ShaderDiskCache(u64 title_id, bool separable);
+
+    /// Returns whether generated shaders are stored for the running title
+    bool IsEnabled() const {
+        return enabled;
+    }
+
+    /// Loads all stored shaders of the title
+    std::vector<ShaderDiskCacheEntry> LoadEntries();
+
+    /// Loads the stored program binaries, keyed by the hash of the GLSL they were built from
+    std::unordered_map<u64, ShaderDiskCacheBinary> LoadBinaries();
+
+    /// Appends a newly generated shader to the cache
+    void SaveEntry(const ShaderDiskCacheEntry& entry);
+
+    /// Appends the binary of a linked separable program built from the given GLSL to the cache
+    void SaveBinary(const std::string& code, GLuint program);
+
+private:
+    /// Opens a cache file for appending, writing a new header if the file is empty
+    bool OpenForAppend(FileUtil::IOFile& file, const std::string& path, u64 valid_size,
+                       const std::string& tag);
+
+    bool separable;
+    bool enabled = false;
+    bool binaries_supported = false;
+
+    std::string entries_path;
+    std::string binaries_path;
+
+    /// Identifies the build that generated the GLSL sources
+    std::string build_tag;
+    /// Identifies the driver that created the program binaries
+    std::string driver_tag;
+
+    /// Size of the files up to the last complete entry, later entries are overwritten
+    u64 entries_valid_size = 0;
+    u64 binaries_valid_size = 0;
+
+    FileUtil::IOFile entries_file;
+    FileUtil::IOFile binaries_file;
+};
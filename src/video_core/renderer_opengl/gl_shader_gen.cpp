@@ -1074,12 +1074,11 @@ void AppendProcTexCombineAndMap(std::string& out, ProcTexCombiner combiner,
     out += "ProcTexLookupLUT(" + offset + ", " + combined + ")";
 }
 
-void AppendProcTexSampler(std::string& out, const PicaFSConfig& config) {
-    // LUT sampling uitlity
-    // For NoiseLUT/ColorMap/AlphaMap, coord=0.0 is lut[0], coord=127.0/128.0 is lut[127] and
-    // coord=1.0 is lut[127]+lut_diff[127]. For other indices, the result is interpolated using
-    // value entries and difference entries.
-    out += R"(
+// LUT sampling uitlity
+// For NoiseLUT/ColorMap/AlphaMap, coord=0.0 is lut[0], coord=127.0/128.0 is lut[127] and
+// coord=1.0 is lut[127]+lut_diff[127]. For other indices, the result is interpolated using
+// value entries and difference entries.
+static const std::string ProcTexLookupLUTDef = R"(
 float ProcTexLookupLUT(int offset, float coord) {
     coord *= 128;
     float index_i = clamp(floor(coord), 0.0, 127.0);
@@ -1088,12 +1087,11 @@ float ProcTexLookupLUT(int offset, float coord) {
     vec2 entry = texelFetch(texture_buffer_lut_rg, int(index_i) + offset).rg;
     return clamp(entry.r + entry.g * index_f, 0.0, 1.0);
 }
-    )";
+)";
 
-    // Noise utility
-    if (config.state.proctex.noise_enable) {
-        // See swrasterizer/proctex.cpp for more information about these functions
-        out += R"(
+// Noise utility
+// See swrasterizer/proctex.cpp for more information about these functions
+static const std::string ProcTexNoiseDef = R"(
 int ProcTexNoiseRand1D(int v) {
     const int table[] = int[](0,4,10,8,4,9,7,12,5,15,13,14,11,15,2,11);
     return ((v % 9 + 2) * 3 & 0xF) ^ table[(v / 9) & 0xF];
@@ -1127,7 +1125,13 @@ float ProcTexNoiseCoef(vec2 x) {
     float x1 = mix(g2, g3, x_noise);
     return mix(x0, x1, y_noise);
 }
-        )";
+)";
+
+void AppendProcTexSampler(std::string& out, const PicaFSConfig& config) {
+    out += ProcTexLookupLUTDef;
+
+    if (config.state.proctex.noise_enable) {
+        out += ProcTexNoiseDef;
     }
 
     out += "vec4 SampleProcTexColor(float lut_coord, int level) {\n";
@@ -1246,9 +1250,8 @@ float ProcTexNoiseCoef(vec2 x) {
     }
 }
 
-std::string GenerateFragmentShader(const PicaFSConfig& config, bool separable_shader) {
-    const auto& state = config.state;
-
+/// Writes the interface, uniforms and helper functions shared by all generated fragment shaders
+static std::string GetFragmentShaderCommonSource(bool separable_shader) {
     std::string out = R"(
 #version 330 core
 #extension GL_ARB_shader_image_load_store : enable
@@ -1326,7 +1329,19 @@ vec3 byteround(vec3 x) {
 vec4 byteround(vec4 x) {
     return round(x * 255.0) * (1.0 / 255.0);
 }
+)";
+
+    return out;
+}
 
+/**
+ * Writes the functions sampling shadow textures
+ * @param perspective_divide GLSL statement applied to the coordinates of 2D shadow textures
+ * @param bias GLSL expression of the depth bias subtracted before comparisons
+ */
+static void AppendShadowTextureSampler(std::string& out, const std::string& perspective_divide,
+                                       const std::string& bias) {
+    out += R"(
 #if ALLOW_SHADOW
 
 uvec2 DecodeShadow(uint pixel) {
@@ -1355,11 +1370,8 @@ float mix2(vec4 s, vec2 a) {
 
 vec4 shadowTexture(vec2 uv, float w) {
 )";
-    if (!config.state.shadow_texture_orthographic) {
-        out += "uv /= w;";
-    }
-    out += "uint z = uint(max(0, int(min(abs(w), 1.0) * 0xFFFFFF) - " +
-           std::to_string(state.shadow_texture_bias) + "));";
+    out += perspective_divide;
+    out += "uint z = uint(max(0, int(min(abs(w), 1.0) * 0xFFFFFF) - " + bias + "));";
     out += R"(
     vec2 coord = vec2(imageSize(shadow_texture_px)) * uv - vec2(0.5);
     vec2 coord_floor = floor(coord);
@@ -1391,8 +1403,7 @@ vec4 shadowTextureCube(vec2 uv, float w) {
         if (c.z > 0.0) uv.x = -uv.x;
     }
 )";
-    out += "uint z = uint(max(0, int(min(w, 1.0) * 0xFFFFFF) - " +
-           std::to_string(state.shadow_texture_bias) + "));";
+    out += "uint z = uint(max(0, int(min(w, 1.0) * 0xFFFFFF) - " + bias + "));";
     out += R"(
     vec2 coord = vec2(size) * (uv / w * vec2(0.5) + vec2(0.5)) - vec2(0.5);
     vec2 coord_floor = floor(coord);
@@ -1469,6 +1480,43 @@ vec4 shadowTextureCube(vec2 uv, float w) {
 
 #endif
 )";
+}
+
+// Merges the depth and the green component of the fragment into the shadow buffer
+static const std::string ShadowBufferWriteDef = R"(
+#if ALLOW_SHADOW
+uint d = uint(clamp(depth, 0.0, 1.0) * 0xFFFFFF);
+uint s = uint(last_tex_env_out.g * 0xFF);
+ivec2 image_coord = ivec2(gl_FragCoord.xy);
+
+uint old = imageLoad(shadow_buffer, image_coord).x;
+uint new;
+uint old2;
+do {
+    old2 = old;
+
+    uvec2 ref = DecodeShadow(old);
+    if (d < ref.x) {
+        if (s == 0u) {
+            ref.x = d;
+        } else {
+            s = uint(float(s) / (shadow_bias_constant + shadow_bias_linear * float(d) / float(ref.x)));
+            ref.y = min(s, ref.y);
+        }
+    }
+    new = EncodeShadow(ref);
+
+} while ((old = imageAtomicCompSwap(shadow_buffer, image_coord, old, new)) != old2);
+#endif // ALLOW_SHADOW
+)";
+
+std::string GenerateFragmentShader(const PicaFSConfig& config, bool separable_shader) {
+    const auto& state = config.state;
+
+    std::string out = GetFragmentShaderCommonSource(separable_shader);
+
+    AppendShadowTextureSampler(out, state.shadow_texture_orthographic ? "" : "uv /= w;",
+                               std::to_string(state.shadow_texture_bias));
 
     if (config.state.proctex.enable)
         AppendProcTexSampler(out, config);
@@ -1553,39 +1601,758 @@ vec4 secondary_fragment_color = vec4(0.0);
     }
 
     if (state.shadow_rendering) {
-        out += R"(
-#if ALLOW_SHADOW
-uint d = uint(clamp(depth, 0.0, 1.0) * 0xFFFFFF);
-uint s = uint(last_tex_env_out.g * 0xFF);
-ivec2 image_coord = ivec2(gl_FragCoord.xy);
+        out += ShadowBufferWriteDef;
+    } else {
+        out += "gl_FragDepth = depth;\n";
+        // Round the final fragment color to maintain the PICA's 8 bits of precision
+        out += "color = byteround(last_tex_env_out);\n";
+    }
 
-uint old = imageLoad(shadow_buffer, image_coord).x;
-uint new;
-uint old2;
-do {
-    old2 = old;
+    out += "}";
 
-    uvec2 ref = DecodeShadow(old);
-    if (d < ref.x) {
-        if (s == 0u) {
-            ref.x = d;
+    return out;
+}
+
+std::string GenerateUberFragmentShader(bool separable_shader) {
+    std::string out = GetFragmentShaderCommonSource(separable_shader);
+
+    // The numeric constants used below are the values of the corresponding Pica register enums,
+    // the layout of uber_config has to match UberShaderUniformData
+    out += R"(
+#define NUM_LIGHTING_LUTS 7
+#define LUT_D0 0
+#define LUT_D1 1
+#define LUT_SP 2
+#define LUT_FR 3
+#define LUT_RR 4
+#define LUT_RG 5
+#define LUT_RB 6
+
+#define LIGHT_DIRECTIONAL 1
+#define LIGHT_TWO_SIDED_DIFFUSE 2
+#define LIGHT_DIST_ATTEN 4
+#define LIGHT_SPOT_ATTEN 8
+#define LIGHT_GEOMETRIC_FACTOR_0 16
+#define LIGHT_GEOMETRIC_FACTOR_1 32
+#define LIGHT_SHADOW 64
+#define LIGHT_TWO_SIDED_LUT 128
+
+struct LightingLut {
+    int enable;
+    int abs_input;
+    int type;
+    float scale;
+};
+
+layout (std140) uniform uber_config {
+    int alpha_test_func;
+    int scissor_test_mode;
+    int texture0_type;
+    int texture2_use_coord1;
+    int combiner_buffer_input;
+    int depthmap_enable;
+    int fog_mode;
+    int fog_flip;
+    int lighting_enable;
+    int lighting_src_num;
+    int lighting_config;
+    int lighting_bump_mode;
+    int lighting_bump_selector;
+    int lighting_bump_renorm;
+    int lighting_clamp_highlights;
+    int lighting_enable_primary_alpha;
+    int lighting_enable_secondary_alpha;
+    int lighting_enable_shadow;
+    int lighting_shadow_primary;
+    int lighting_shadow_secondary;
+    int lighting_shadow_invert;
+    int lighting_shadow_alpha;
+    int lighting_shadow_selector;
+    int proctex_enable;
+    int proctex_coord;
+    int proctex_u_clamp;
+    int proctex_v_clamp;
+    int proctex_color_combiner;
+    int proctex_alpha_combiner;
+    int proctex_separate_alpha;
+    int proctex_noise_enable;
+    int proctex_u_shift;
+    int proctex_v_shift;
+    int proctex_lut_width;
+    int proctex_lut_filter;
+    float proctex_lod_min;
+    float proctex_lod_max;
+    int shadow_rendering;
+    int shadow_texture_orthographic;
+    int shadow_texture_bias;
+    ivec4 proctex_lut_offsets;
+    uvec4 tev_stages[NUM_TEV_STAGES];
+    ivec4 lighting_lights[NUM_LIGHTS];
+    LightingLut lighting_luts[NUM_LIGHTING_LUTS];
+};
+
+vec4 rounded_primary_color = vec4(0.0);
+vec4 primary_fragment_color = vec4(0.0);
+vec4 secondary_fragment_color = vec4(0.0);
+vec4 texcolor0 = vec4(0.0);
+vec4 texcolor1 = vec4(0.0);
+vec4 texcolor2 = vec4(0.0);
+vec4 texcolor3 = vec4(0.0);
+vec4 combiner_buffer = vec4(0.0);
+vec4 last_tex_env_out = vec4(0.0);
+
+vec3 normal = vec3(0.0);
+vec3 tangent = vec3(0.0);
+vec3 light_vector = vec3(0.0);
+vec3 half_vector = vec3(0.0);
+vec3 spot_dir = vec3(0.0);
+)";
+
+    AppendShadowTextureSampler(out, "if (shadow_texture_orthographic == 0) uv /= w;",
+                               "shadow_texture_bias");
+
+    out += ProcTexLookupLUTDef;
+    out += ProcTexNoiseDef;
+
+    out += R"(
+float ProcTexShiftOffset(int mode, int clamp_mode, float v) {
+    float offset = clamp_mode == 3 ? 1.0 : 0.5;
+    switch (mode) {
+    case 1: // Odd
+        return offset * float((int(v) / 2) % 2);
+    case 2: // Even
+        return offset * float(((int(v) + 1) / 2) % 2);
+    default:
+        return 0.0;
+    }
+}
+
+float ProcTexClamp(int mode, float x) {
+    switch (mode) {
+    case 0: // ToZero
+        return x > 1.0 ? 0.0 : x;
+    case 2: // SymmetricalRepeat
+        return fract(x);
+    case 3: // MirroredRepeat
+        return int(x) % 2 == 0 ? fract(x) : 1.0 - fract(x);
+    case 4: // Pulse
+        return x > 0.5 ? 1.0 : 0.0;
+    default: // ToEdge
+        return min(x, 1.0);
+    }
+}
+
+float ProcTexCombineAndMap(int combiner, float u, float v, int offset) {
+    float combined;
+    switch (combiner) {
+    case 0: // U
+        combined = u;
+        break;
+    case 1: // U2
+        combined = u * u;
+        break;
+    case 2: // V
+        combined = v;
+        break;
+    case 3: // V2
+        combined = v * v;
+        break;
+    case 4: // Add
+        combined = (u + v) * 0.5;
+        break;
+    case 5: // Add2
+        combined = (u * u + v * v) * 0.5;
+        break;
+    case 6: // SqrtAdd2
+        combined = min(sqrt(u * u + v * v), 1.0);
+        break;
+    case 7: // Min
+        combined = min(u, v);
+        break;
+    case 8: // Max
+        combined = max(u, v);
+        break;
+    case 9: // RMax
+        combined = min(((u + v) * 0.5 + sqrt(u * u + v * v)) * 0.5, 1.0);
+        break;
+    default:
+        combined = 0.0;
+        break;
+    }
+    return ProcTexLookupLUT(offset, combined);
+}
+
+vec4 SampleProcTexColor(float lut_coord, int level) {
+    int lut_width = proctex_lut_width >> level;
+    // Offsets for level 4-7 seem to be hardcoded
+    int lut_offsets[8] = int[](proctex_lut_offsets.x, proctex_lut_offsets.y,
+                               proctex_lut_offsets.z, proctex_lut_offsets.w,
+                               0xF0, 0xF8, 0xFC, 0xFE);
+    int lut_offset = lut_offsets[level];
+    // For the color lut, coord=0.0 is lut[offset] and coord=1.0 is lut[offset+width-1]
+    lut_coord *= float(lut_width - 1);
+
+    // Linear, LinearMipmapNearest and LinearMipmapLinear have odd values
+    if ((proctex_lut_filter & 1) != 0) {
+        int lut_index_i = int(lut_coord) + lut_offset;
+        float lut_index_f = fract(lut_coord);
+        return texelFetch(texture_buffer_lut_rgba, lut_index_i + proctex_lut_offset) +
+               lut_index_f *
+                   texelFetch(texture_buffer_lut_rgba, lut_index_i + proctex_diff_lut_offset);
+    }
+    lut_coord += float(lut_offset);
+    return texelFetch(texture_buffer_lut_rgba, int(round(lut_coord)) + proctex_lut_offset);
+}
+
+vec4 ProcTex() {
+    vec2 uv = abs(proctex_coord == 1 ? texcoord1 : (proctex_coord == 2 ? texcoord2 : texcoord0));
+
+    // This LOD formula is the same as the LOD upper limit defined in OpenGL.
+    // f(x, y) <= m_u + m_v + m_w
+    // (See OpenGL 4.6 spec, 8.14.1 - Scale Factor and Level-of-Detail)
+    // Note: this is different from the one normal 2D textures use.
+    vec2 duv = max(abs(dFdx(uv)), abs(dFdy(uv)));
+    // unlike normal texture, the bias is inside the log2
+    float lod = log2(abs(float(proctex_lut_width) * proctex_bias) * (duv.x + duv.y));
+    if (proctex_bias == 0.0) lod = 0.0;
+    lod = clamp(lod, proctex_lod_min, proctex_lod_max);
+
+    // Get shift offset before noise generation
+    float u_shift = ProcTexShiftOffset(proctex_u_shift, proctex_u_clamp, uv.y);
+    float v_shift = ProcTexShiftOffset(proctex_v_shift, proctex_v_clamp, uv.x);
+
+    if (proctex_noise_enable != 0) {
+        uv += proctex_noise_a * ProcTexNoiseCoef(uv);
+        uv = abs(uv);
+    }
+
+    float u = ProcTexClamp(proctex_u_clamp, uv.x + u_shift);
+    float v = ProcTexClamp(proctex_v_clamp, uv.y + v_shift);
+
+    float lut_coord = ProcTexCombineAndMap(proctex_color_combiner, u, v, proctex_color_map_offset);
+
+    vec4 final_color;
+    switch (proctex_lut_filter) {
+    case 2: // NearestMipmapNearest
+    case 3: // LinearMipmapNearest
+        final_color = SampleProcTexColor(lut_coord, int(round(lod)));
+        break;
+    case 4: // NearestMipmapLinear
+    case 5: { // LinearMipmapLinear
+        int lod_i = int(lod);
+        float lod_f = fract(lod);
+        final_color = mix(SampleProcTexColor(lut_coord, lod_i),
+                          SampleProcTexColor(lut_coord, lod_i + 1), lod_f);
+        break;
+    }
+    default: // Nearest, Linear
+        final_color = SampleProcTexColor(lut_coord, 0);
+        break;
+    }
+
+    // Note: in separate alpha mode, the alpha channel skips the color LUT look up stage. It
+    // uses the output of CombineAndMap directly instead.
+    if (proctex_separate_alpha != 0) {
+        final_color.a =
+            ProcTexCombineAndMap(proctex_alpha_combiner, u, v, proctex_alpha_map_offset);
+    }
+    return final_color;
+}
+
+int BitField(uint value, int offset, int size) {
+    return int((value >> uint(offset)) & ((1u << uint(size)) - 1u));
+}
+
+vec4 SampleTexture0() {
+    switch (texture0_type) {
+    case 0: // Texture2D
+        return texture(tex0, texcoord0);
+    case 1: // TextureCube
+        return texture(tex_cube, vec3(texcoord0, texcoord0_w));
+    case 2: // Shadow2D
+        return shadowTexture(texcoord0, texcoord0_w);
+    case 3: // Projection2D
+        return textureProj(tex0, vec3(texcoord0, texcoord0_w));
+    case 4: // ShadowCube
+        return shadowTextureCube(texcoord0, texcoord0_w);
+    default:
+        return vec4(0.0);
+    }
+}
+
+vec4 GetTexColor(int unit) {
+    switch (unit) {
+    case 0:
+        return texcolor0;
+    case 1:
+        return texcolor1;
+    case 2:
+        return texcolor2;
+    default:
+        return texcolor3;
+    }
+}
+
+vec4 GetSource(int source, int stage) {
+    switch (source) {
+    case 0:
+        return rounded_primary_color;
+    case 1:
+        return primary_fragment_color;
+    case 2:
+        return secondary_fragment_color;
+    case 3:
+        return texcolor0;
+    case 4:
+        return texcolor1;
+    case 5:
+        return texcolor2;
+    case 6:
+        return texcolor3;
+    case 13:
+        return combiner_buffer;
+    case 14:
+        return const_color[stage];
+    case 15:
+        return last_tex_env_out;
+    default:
+        return vec4(0.0);
+    }
+}
+
+vec3 GetColorModifier(int modifier, vec4 value) {
+    switch (modifier) {
+    case 0:
+        return value.rgb;
+    case 1:
+        return vec3(1.0) - value.rgb;
+    case 2:
+        return value.aaa;
+    case 3:
+        return vec3(1.0) - value.aaa;
+    case 4:
+        return value.rrr;
+    case 5:
+        return vec3(1.0) - value.rrr;
+    case 8:
+        return value.ggg;
+    case 9:
+        return vec3(1.0) - value.ggg;
+    case 12:
+        return value.bbb;
+    case 13:
+        return vec3(1.0) - value.bbb;
+    default:
+        return vec3(0.0);
+    }
+}
+
+float GetAlphaModifier(int modifier, vec4 value) {
+    switch (modifier) {
+    case 0:
+        return value.a;
+    case 1:
+        return 1.0 - value.a;
+    case 2:
+        return value.r;
+    case 3:
+        return 1.0 - value.r;
+    case 4:
+        return value.g;
+    case 5:
+        return 1.0 - value.g;
+    case 6:
+        return value.b;
+    case 7:
+        return 1.0 - value.b;
+    default:
+        return 0.0;
+    }
+}
+
+vec3 CombineColor(int operation, vec3 v[3]) {
+    vec3 result;
+    switch (operation) {
+    case 0: // Replace
+        result = v[0];
+        break;
+    case 1: // Modulate
+        result = v[0] * v[1];
+        break;
+    case 2: // Add
+        result = v[0] + v[1];
+        break;
+    case 3: // AddSigned
+        result = v[0] + v[1] - vec3(0.5);
+        break;
+    case 4: // Lerp
+        result = v[0] * v[2] + v[1] * (vec3(1.0) - v[2]);
+        break;
+    case 5: // Subtract
+        result = v[0] - v[1];
+        break;
+    case 6: // Dot3_RGB
+    case 7: // Dot3_RGBA
+        result = vec3(dot(v[0] - vec3(0.5), v[1] - vec3(0.5)) * 4.0);
+        break;
+    case 8: // MultiplyThenAdd
+        result = v[0] * v[1] + v[2];
+        break;
+    case 9: // AddThenMultiply
+        result = min(v[0] + v[1], vec3(1.0)) * v[2];
+        break;
+    default:
+        result = vec3(0.0);
+        break;
+    }
+    return clamp(result, vec3(0.0), vec3(1.0));
+}
+
+float CombineAlpha(int operation, float v[3]) {
+    float result;
+    switch (operation) {
+    case 0: // Replace
+        result = v[0];
+        break;
+    case 1: // Modulate
+        result = v[0] * v[1];
+        break;
+    case 2: // Add
+        result = v[0] + v[1];
+        break;
+    case 3: // AddSigned
+        result = v[0] + v[1] - 0.5;
+        break;
+    case 4: // Lerp
+        result = v[0] * v[2] + v[1] * (1.0 - v[2]);
+        break;
+    case 5: // Subtract
+        result = v[0] - v[1];
+        break;
+    case 8: // MultiplyThenAdd
+        result = v[0] * v[1] + v[2];
+        break;
+    case 9: // AddThenMultiply
+        result = min(v[0] + v[1], 1.0) * v[2];
+        break;
+    default:
+        result = 0.0;
+        break;
+    }
+    return clamp(result, 0.0, 1.0);
+}
+
+float GetMultiplier(int scale) {
+    return scale < 3 ? float(1 << scale) : 1.0;
+}
+
+void WriteTevStage(int index, inout vec4 next_combiner_buffer) {
+    uvec4 stage = tev_stages[index];
+    int color_op = BitField(stage.z, 0, 4);
+    int alpha_op = BitField(stage.z, 16, 4);
+
+    vec3 color_results[3] = vec3[3](
+        GetColorModifier(BitField(stage.y, 0, 4), GetSource(BitField(stage.x, 0, 4), index)),
+        GetColorModifier(BitField(stage.y, 4, 4), GetSource(BitField(stage.x, 4, 4), index)),
+        GetColorModifier(BitField(stage.y, 8, 4), GetSource(BitField(stage.x, 8, 4), index)));
+    // Round the output of each TEV stage to maintain the PICA's 8 bits of precision
+    vec3 color_output = byteround(CombineColor(color_op, color_results));
+
+    float alpha_output;
+    if (color_op == 7) {
+        // result of Dot3_RGBA operation is also placed to the alpha component
+        alpha_output = color_output[0];
+    } else {
+        float alpha_results[3] = float[3](
+            GetAlphaModifier(BitField(stage.y, 12, 3), GetSource(BitField(stage.x, 16, 4), index)),
+            GetAlphaModifier(BitField(stage.y, 16, 3), GetSource(BitField(stage.x, 20, 4), index)),
+            GetAlphaModifier(BitField(stage.y, 20, 3), GetSource(BitField(stage.x, 24, 4), index)));
+        alpha_output = byteround(CombineAlpha(alpha_op, alpha_results));
+    }
+
+    last_tex_env_out = vec4(
+        clamp(color_output * GetMultiplier(BitField(stage.w, 0, 2)), vec3(0.0), vec3(1.0)),
+        clamp(alpha_output * GetMultiplier(BitField(stage.w, 16, 2)), 0.0, 1.0));
+
+    combiner_buffer = next_combiner_buffer;
+    if (index < 4) {
+        if ((combiner_buffer_input & (1 << index)) != 0)
+            next_combiner_buffer.rgb = last_tex_env_out.rgb;
+        if ((combiner_buffer_input & (16 << index)) != 0)
+            next_combiner_buffer.a = last_tex_env_out.a;
+    }
+}
+
+bool AlphaTestFails(int alpha) {
+    switch (alpha_test_func) {
+    case 0: // Never
+        return true;
+    case 2: // Equal
+        return alpha != alphatest_ref;
+    case 3: // NotEqual
+        return alpha == alphatest_ref;
+    case 4: // LessThan
+        return alpha >= alphatest_ref;
+    case 5: // LessThanOrEqual
+        return alpha > alphatest_ref;
+    case 6: // GreaterThan
+        return alpha <= alphatest_ref;
+    case 7: // GreaterThanOrEqual
+        return alpha < alphatest_ref;
+    default:
+        return false;
+    }
+}
+
+// Samples the specified lookup table for specular lighting, including its scale
+float GetLutValue(int lut, int sampler, bool two_sided) {
+    float index;
+    switch (lighting_luts[lut].type) {
+    case 0: // NH
+        index = dot(normal, normalize(half_vector));
+        break;
+    case 1: // VH
+        index = dot(normalize(view), normalize(half_vector));
+        break;
+    case 2: // NV
+        index = dot(normal, normalize(view));
+        break;
+    case 3: // LN
+        index = dot(light_vector, normal);
+        break;
+    case 4: // SP
+        index = dot(light_vector, spot_dir);
+        break;
+    case 5: // CP
+        // CP input is only available with configuration 7
+        if (lighting_config == 8) {
+            vec3 half_angle_proj =
+                normalize(half_vector) - normal * dot(normal, normalize(half_vector));
+            index = dot(half_angle_proj, tangent);
         } else {
-            s = uint(float(s) / (shadow_bias_constant + shadow_bias_linear * float(d) / float(ref.x)));
-            ref.y = min(s, ref.y);
+            index = 0.0;
         }
+        break;
+    default:
+        index = 0.0;
+        break;
     }
-    new = EncodeShadow(ref);
 
-} while ((old = imageAtomicCompSwap(shadow_buffer, image_coord, old, new)) != old2);
-#endif // ALLOW_SHADOW
-)";
+    float value;
+    if (lighting_luts[lut].abs_input != 0) {
+        // LUT index is in the range of (0.0, 1.0)
+        index = two_sided ? abs(index) : max(index, 0.0);
+        value = LookupLightingLUTUnsigned(sampler, index);
     } else {
-        out += "gl_FragDepth = depth;\n";
-        // Round the final fragment color to maintain the PICA's 8 bits of precision
-        out += "color = byteround(last_tex_env_out);\n";
+        // LUT index is in the range of (-1.0, 1.0)
+        value = LookupLightingLUTSigned(sampler, index);
     }
+    return lighting_luts[lut].scale * value;
+}
 
-    out += "}";
+void ComputeLighting() {
+    vec4 diffuse_sum = vec4(0.0, 0.0, 0.0, 1.0);
+    vec4 specular_sum = vec4(0.0, 0.0, 0.0, 1.0);
+    vec3 refl_value = vec3(0.0);
+    float dot_product = 0.0;
+    float clamp_highlights = 1.0;
+    float geo_factor = 1.0;
+
+    // Compute fragment normals and tangents
+    vec3 surface_normal = vec3(0.0, 0.0, 1.0);
+    vec3 surface_tangent = vec3(1.0, 0.0, 0.0);
+    if (lighting_bump_mode == 1) {
+        // Bump mapping is enabled using a normal map
+        surface_normal = 2.0 * GetTexColor(lighting_bump_selector).rgb - 1.0;
+        if (lighting_bump_renorm != 0) {
+            surface_normal.z = sqrt(max((1.0 - (surface_normal.x*surface_normal.x +
+                                                surface_normal.y*surface_normal.y)), 0.0));
+        }
+    } else if (lighting_bump_mode == 2) {
+        // Bump mapping is enabled using a tangent map
+        surface_tangent = 2.0 * GetTexColor(lighting_bump_selector).rgb - 1.0;
+    }
+
+    vec4 normalized_normquat = normalize(normquat);
+    normal = quaternion_rotate(normalized_normquat, surface_normal);
+    tangent = quaternion_rotate(normalized_normquat, surface_tangent);
+
+    vec4 shadow = vec4(1.0);
+    if (lighting_enable_shadow != 0) {
+        shadow = GetTexColor(lighting_shadow_selector);
+        if (lighting_shadow_invert != 0)
+            shadow = vec4(1.0) - shadow;
+    }
+
+    for (int slot = 0; slot < lighting_src_num; ++slot) {
+        int num = lighting_lights[slot].x;
+        int flags = lighting_lights[slot].y;
+        bool two_sided_lut = (flags & LIGHT_TWO_SIDED_LUT) != 0;
+
+        // Compute light vector (directional or positional)
+        if ((flags & LIGHT_DIRECTIONAL) != 0)
+            light_vector = normalize(light_src[num].position);
+        else
+            light_vector = normalize(light_src[num].position + view);
+
+        spot_dir = light_src[num].spot_direction;
+        half_vector = normalize(view) + light_vector;
+
+        // Compute dot product of light_vector and normal, adjust if lighting is one-sided or
+        // two-sided
+        if ((flags & LIGHT_TWO_SIDED_DIFFUSE) != 0)
+            dot_product = abs(dot(light_vector, normal));
+        else
+            dot_product = max(dot(light_vector, normal), 0.0);
+
+        // If enabled, clamp specular component if lighting result is zero
+        if (lighting_clamp_highlights != 0)
+            clamp_highlights = sign(dot_product);
+
+        float spot_atten = 1.0;
+        if ((flags & LIGHT_SPOT_ATTEN) != 0)
+            spot_atten = GetLutValue(LUT_SP, 8 + num, two_sided_lut);
+
+        float dist_atten = 1.0;
+        if ((flags & LIGHT_DIST_ATTEN) != 0) {
+            float index = clamp(light_src[num].dist_atten_scale *
+                                length(-view - light_src[num].position) +
+                                light_src[num].dist_atten_bias, 0.0, 1.0);
+            dist_atten = LookupLightingLUTUnsigned(16 + num, index);
+        }
+
+        if ((flags & (LIGHT_GEOMETRIC_FACTOR_0 | LIGHT_GEOMETRIC_FACTOR_1)) != 0) {
+            geo_factor = dot(half_vector, half_vector);
+            geo_factor = geo_factor == 0.0 ? 0.0 : min(dot_product / geo_factor, 1.0);
+        }
+
+        // Specular 0 component
+        float d0_lut_value = 1.0;
+        if (lighting_luts[LUT_D0].enable != 0)
+            d0_lut_value = GetLutValue(LUT_D0, 0, two_sided_lut);
+        vec3 specular_0 = d0_lut_value * light_src[num].specular_0;
+        if ((flags & LIGHT_GEOMETRIC_FACTOR_0) != 0)
+            specular_0 *= geo_factor;
+
+        // Lookup the enabled reflection LUTs, green and blue default to the red value
+        refl_value.r = 1.0;
+        if (lighting_luts[LUT_RR].enable != 0)
+            refl_value.r = GetLutValue(LUT_RR, 6, two_sided_lut);
+        refl_value.g = refl_value.r;
+        if (lighting_luts[LUT_RG].enable != 0)
+            refl_value.g = GetLutValue(LUT_RG, 5, two_sided_lut);
+        refl_value.b = refl_value.r;
+        if (lighting_luts[LUT_RB].enable != 0)
+            refl_value.b = GetLutValue(LUT_RB, 4, two_sided_lut);
+
+        // Specular 1 component
+        float d1_lut_value = 1.0;
+        if (lighting_luts[LUT_D1].enable != 0)
+            d1_lut_value = GetLutValue(LUT_D1, 1, two_sided_lut);
+        vec3 specular_1 = d1_lut_value * refl_value * light_src[num].specular_1;
+        if ((flags & LIGHT_GEOMETRIC_FACTOR_1) != 0)
+            specular_1 *= geo_factor;
+
+        // Note: only the last entry in the light slots applies the Fresnel factor
+        if (slot == lighting_src_num - 1 && lighting_luts[LUT_FR].enable != 0) {
+            float fresnel = GetLutValue(LUT_FR, 3, two_sided_lut);
+            if (lighting_enable_primary_alpha != 0)
+                diffuse_sum.a = fresnel;
+            if (lighting_enable_secondary_alpha != 0)
+                specular_sum.a = fresnel;
+        }
+
+        bool shadow_enable = (flags & LIGHT_SHADOW) != 0;
+        vec3 shadow_primary =
+            lighting_shadow_primary != 0 && shadow_enable ? shadow.rgb : vec3(1.0);
+        vec3 shadow_secondary =
+            lighting_shadow_secondary != 0 && shadow_enable ? shadow.rgb : vec3(1.0);
+
+        diffuse_sum.rgb += ((light_src[num].diffuse * dot_product) + light_src[num].ambient) *
+                           dist_atten * spot_atten * shadow_primary;
+        specular_sum.rgb += (specular_0 + specular_1) * clamp_highlights * dist_atten *
+                            spot_atten * shadow_secondary;
+    }
+
+    // Apply shadow attenuation to alpha components if enabled
+    if (lighting_shadow_alpha != 0) {
+        if (lighting_enable_primary_alpha != 0)
+            diffuse_sum.a *= shadow.a;
+        if (lighting_enable_secondary_alpha != 0)
+            specular_sum.a *= shadow.a;
+    }
+
+    diffuse_sum.rgb += lighting_global_ambient;
+    primary_fragment_color = clamp(diffuse_sum, vec4(0.0), vec4(1.0));
+    secondary_fragment_color = clamp(specular_sum, vec4(0.0), vec4(1.0));
+}
+
+void main() {
+    // Sample the textures in uniform control flow, the TEV stages select from the results
+    texcolor0 = SampleTexture0();
+    texcolor1 = texture(tex1, texcoord1);
+    texcolor2 = texture(tex2, texture2_use_coord1 != 0 ? texcoord1 : texcoord2);
+    if (proctex_enable != 0)
+        texcolor3 = ProcTex();
+    rounded_primary_color = byteround(primary_color);
+
+    if (alpha_test_func == 0)
+        discard;
+
+    if (scissor_test_mode != 0) {
+        bool inside = gl_FragCoord.x >= scissor_x1 && gl_FragCoord.y >= scissor_y1 &&
+                      gl_FragCoord.x < scissor_x2 && gl_FragCoord.y < scissor_y2;
+        // Include mode keeps only the pixels inside the scissor box
+        if (inside != (scissor_test_mode == 3))
+            discard;
+    }
+
+    float z_over_w = 2.0 * gl_FragCoord.z - 1.0;
+    float depth = z_over_w * depth_scale + depth_offset;
+    if (depthmap_enable == 0)
+        depth /= gl_FragCoord.w;
+
+    if (lighting_enable != 0)
+        ComputeLighting();
+
+    vec4 next_combiner_buffer = tev_combiner_buffer_color;
+    for (int i = 0; i < NUM_TEV_STAGES; ++i)
+        WriteTevStage(i, next_combiner_buffer);
+
+    if (AlphaTestFails(int(last_tex_env_out.a * 255.0)))
+        discard;
+
+    if (fog_mode == 5) {
+        // Get index into fog LUT
+        float fog_index = (fog_flip != 0 ? 1.0 - depth : depth) * 128.0;
+
+        // Generate clamped fog factor from LUT for given fog index
+        float fog_i = clamp(floor(fog_index), 0.0, 127.0);
+        float fog_f = fog_index - fog_i;
+        vec2 fog_lut_entry = texelFetch(texture_buffer_lut_rg, int(fog_i) + fog_lut_offset).rg;
+        float fog_factor = clamp(fog_lut_entry.r + fog_lut_entry.g * fog_f, 0.0, 1.0);
+
+        // Blend the fog
+        last_tex_env_out.rgb = mix(fog_color.rgb, last_tex_env_out.rgb, fog_factor);
+    } else if (fog_mode == 7) {
+        // Gas mode is not implemented
+        discard;
+    }
+
+    if (shadow_rendering != 0) {
+)";
+
+    out += ShadowBufferWriteDef;
+
+    out += R"(
+        return;
+    }
+
+    gl_FragDepth = depth;
+    // Round the final fragment color to maintain the PICA's 8 bits of precision
+    color = byteround(last_tex_env_out);
+}
+)";
 
     return out;
 }
@@ -166,6 +166,7 @@ struct PicaShaderConfigCommon {
  * shader.
  */
 struct PicaVSConfig : Common::HashableStruct<PicaShaderConfigCommon> {
+    PicaVSConfig() = default;
     explicit PicaVSConfig(const Pica::Regs& regs, Pica::Shader::ShaderSetup& setup) {
         state.Init(regs.vs, setup);
     }
@@ -191,6 +192,7 @@ struct PicaGSConfigCommonRaw {
  * shader pipeline
  */
 struct PicaFixedGSConfig : Common::HashableStruct<PicaGSConfigCommonRaw> {
+    PicaFixedGSConfig() = default;
     explicit PicaFixedGSConfig(const Pica::Regs& regs) {
         state.Init(regs);
     }
@@ -211,6 +213,7 @@ struct PicaGSConfigRaw : PicaShaderConfigCommon, PicaGSConfigCommonRaw {
  * shader.
  */
 struct PicaGSConfig : Common::HashableStruct<PicaGSConfigRaw> {
+    PicaGSConfig() = default;
     explicit PicaGSConfig(const Pica::Regs& regs, Pica::Shader::ShaderSetup& setups) {
         state.Init(regs, setups);
     }
@@ -255,6 +258,14 @@ std::optional<std::string> GenerateGeometryShader(const Pica::Shader::ShaderSetu
  */
 std::string GenerateFragmentShader(const PicaFSConfig& config, bool separable_shader);
 
+/**
+ * Generates the GLSL source of the uber fragment shader, which emulates any Pica state by reading
+ * the configuration from the uber_config uniform block instead of baking it into the code
+ * @param separable_shader generates shader that can be used for separate shader object
+ * @returns String of the shader source code
+ */
+std::string GenerateUberFragmentShader(bool separable_shader);
+
 } // namespace GLShader
 
 namespace std {
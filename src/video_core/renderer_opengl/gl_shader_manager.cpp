@@ -3,9 +3,14 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
+#include <optional>
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
 #include <boost/variant.hpp>
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
 
 static void SetShaderUniformBlockBinding(GLuint shader, const char* name, UniformBindings binding,
@@ -26,6 +31,8 @@ static void SetShaderUniformBlockBindings(GLuint shader) {
                                  sizeof(UniformData));
     SetShaderUniformBlockBinding(shader, "vs_config", UniformBindings::VS, sizeof(VSUniformData));
     SetShaderUniformBlockBinding(shader, "gs_config", UniformBindings::GS, sizeof(GSUniformData));
+    SetShaderUniformBlockBinding(shader, "uber_config", UniformBindings::Uber,
+                                 sizeof(UberShaderUniformData));
 }
 
 static void SetShaderSamplerBinding(GLuint shader, const char* name,
@@ -85,6 +92,103 @@ void PicaUniformsData::SetFromRegs(const Pica::ShaderRegs& regs,
                    });
 }
 
+void UberShaderUniformData::SetFromConfig(const GLShader::PicaFSConfig& config) {
+    using Pica::LightingRegs;
+    const auto& state = config.state;
+    const auto& lighting = state.lighting;
+
+    alpha_test_func = static_cast<GLint>(state.alpha_test_func);
+    scissor_test_mode = static_cast<GLint>(state.scissor_test_mode);
+    texture0_type = static_cast<GLint>(state.texture0_type);
+    texture2_use_coord1 = state.texture2_use_coord1;
+    combiner_buffer_input = state.combiner_buffer_input;
+    depthmap_enable = static_cast<GLint>(state.depthmap_enable);
+    fog_mode = static_cast<GLint>(state.fog_mode);
+    fog_flip = state.fog_flip;
+
+    lighting_enable = lighting.enable;
+    lighting_src_num = static_cast<GLint>(lighting.src_num);
+    lighting_config = static_cast<GLint>(lighting.config);
+    lighting_bump_mode = static_cast<GLint>(lighting.bump_mode);
+    lighting_bump_selector = static_cast<GLint>(lighting.bump_selector);
+    lighting_bump_renorm = lighting.bump_renorm;
+    lighting_clamp_highlights = lighting.clamp_highlights;
+    lighting_enable_primary_alpha = lighting.enable_primary_alpha;
+    lighting_enable_secondary_alpha = lighting.enable_secondary_alpha;
+    lighting_enable_shadow = lighting.enable_shadow;
+    lighting_shadow_primary = lighting.shadow_primary;
+    lighting_shadow_secondary = lighting.shadow_secondary;
+    lighting_shadow_invert = lighting.shadow_invert;
+    lighting_shadow_alpha = lighting.shadow_alpha;
+    lighting_shadow_selector = static_cast<GLint>(lighting.shadow_selector);
+
+    const auto& proctex = state.proctex;
+    proctex_enable = proctex.enable;
+    proctex_coord = static_cast<GLint>(proctex.coord);
+    proctex_u_clamp = static_cast<GLint>(proctex.u_clamp);
+    proctex_v_clamp = static_cast<GLint>(proctex.v_clamp);
+    proctex_color_combiner = static_cast<GLint>(proctex.color_combiner);
+    proctex_alpha_combiner = static_cast<GLint>(proctex.alpha_combiner);
+    proctex_separate_alpha = proctex.separate_alpha;
+    proctex_noise_enable = proctex.noise_enable;
+    proctex_u_shift = static_cast<GLint>(proctex.u_shift);
+    proctex_v_shift = static_cast<GLint>(proctex.v_shift);
+    proctex_lut_width = static_cast<GLint>(proctex.lut_width);
+    proctex_lut_filter = static_cast<GLint>(proctex.lut_filter);
+    proctex_lod_min = static_cast<GLfloat>(proctex.lod_min);
+    proctex_lod_max = std::min(7.0f, static_cast<GLfloat>(proctex.lod_max));
+    proctex_lut_offsets = {static_cast<GLint>(proctex.lut_offset0),
+                           static_cast<GLint>(proctex.lut_offset1),
+                           static_cast<GLint>(proctex.lut_offset2),
+                           static_cast<GLint>(proctex.lut_offset3)};
+
+    shadow_rendering = state.shadow_rendering;
+    shadow_texture_orthographic = state.shadow_texture_orthographic;
+    shadow_texture_bias = static_cast<GLint>(state.shadow_texture_bias);
+
+    for (std::size_t i = 0; i < state.tev_stages.size(); ++i) {
+        const auto& stage = state.tev_stages[i];
+        tev_stages[i] = {stage.sources_raw, stage.modifiers_raw, stage.ops_raw, stage.scales_raw};
+    }
+
+    const auto is_supported = [&lighting](LightingRegs::LightingSampler sampler) {
+        return LightingRegs::IsLightingSamplerSupported(lighting.config, sampler);
+    };
+
+    const bool spot_atten_supported =
+        is_supported(LightingRegs::LightingSampler::SpotlightAttenuation);
+    for (std::size_t i = 0; i < std::size(lighting_lights); ++i) {
+        const auto& light = lighting.light[i];
+        GLint flags = 0;
+        flags |= light.directional ? LightDirectional : 0;
+        flags |= light.two_sided_diffuse ? LightTwoSidedDiffuse : 0;
+        flags |= light.dist_atten_enable ? LightDistAtten : 0;
+        flags |= light.spot_atten_enable && spot_atten_supported ? LightSpotAtten : 0;
+        flags |= light.geometric_factor_0 ? LightGeometricFactor0 : 0;
+        flags |= light.geometric_factor_1 ? LightGeometricFactor1 : 0;
+        flags |= light.shadow_enable ? LightShadow : 0;
+        // The LUT inputs of the specialized shader take the two-sided flag from the light slot
+        // with the index of the light rather than from the slot itself
+        flags |= lighting.light[light.num].two_sided_diffuse ? LightTwoSidedLut : 0;
+        lighting_lights[i] = {static_cast<GLint>(light.num), flags, 0, 0};
+    }
+
+    const auto set_lut = [&is_supported](LightingLut& lut, const auto& lut_config,
+                                         LightingRegs::LightingSampler sampler) {
+        lut.enable = lut_config.enable && is_supported(sampler);
+        lut.abs_input = lut_config.abs_input;
+        lut.type = static_cast<GLint>(lut_config.type);
+        lut.scale = lut_config.scale;
+    };
+    set_lut(lighting_luts[0], lighting.lut_d0, LightingRegs::LightingSampler::Distribution0);
+    set_lut(lighting_luts[1], lighting.lut_d1, LightingRegs::LightingSampler::Distribution1);
+    set_lut(lighting_luts[2], lighting.lut_sp, LightingRegs::LightingSampler::SpotlightAttenuation);
+    set_lut(lighting_luts[3], lighting.lut_fr, LightingRegs::LightingSampler::Fresnel);
+    set_lut(lighting_luts[4], lighting.lut_rr, LightingRegs::LightingSampler::ReflectRed);
+    set_lut(lighting_luts[5], lighting.lut_rg, LightingRegs::LightingSampler::ReflectGreen);
+    set_lut(lighting_luts[6], lighting.lut_rb, LightingRegs::LightingSampler::ReflectBlue);
+}
+
 /**
  * An object representing a shader program staging. It can be either a shader object or a program
  * object, depending on whether separable program is used.
@@ -112,6 +216,83 @@ public:
         }
     }
 
+    /// Creates the separable program from a binary retrieved from the driver in an earlier run.
+    /// Returns false if the program is not separable or the driver rejects the binary.
+    bool CreateFromBinary(const ShaderDiskCacheBinary& binary) {
+        if (shader_or_program.which() == 0)
+            return false;
+
+        OGLProgram& program = boost::get<OGLProgram>(shader_or_program);
+        program.handle = glCreateProgram();
+        glProgramParameteri(program.handle, GL_PROGRAM_SEPARABLE, GL_TRUE);
+        glProgramBinary(program.handle, binary.format, binary.data.data(),
+                        static_cast<GLsizei>(binary.data.size()));
+
+        GLint link_status = GL_FALSE;
+        glGetProgramiv(program.handle, GL_LINK_STATUS, &link_status);
+        if (link_status != GL_TRUE) {
+            program.Release();
+            return false;
+        }
+
+        SetShaderUniformBlockBindings(program.handle);
+        SetShaderSamplerBindings(program.handle);
+        return true;
+    }
+
+    /// Starts compiling and linking the separable program without waiting for the result, which
+    /// lets a driver supporting parallel shader compilation build it in the background
+    void CreateAsync(const char* source, GLenum type) {
+        ASSERT(shader_or_program.which() == 1);
+        compiling_shader.handle = glCreateShader(type);
+        glShaderSource(compiling_shader.handle, 1, &source, nullptr);
+        glCompileShader(compiling_shader.handle);
+
+        OGLProgram& program = boost::get<OGLProgram>(shader_or_program);
+        program.handle = glCreateProgram();
+        glProgramParameteri(program.handle, GL_PROGRAM_SEPARABLE, GL_TRUE);
+        if (GLAD_GL_ARB_get_program_binary) {
+            glProgramParameteri(program.handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        glAttachShader(program.handle, compiling_shader.handle);
+        glLinkProgram(program.handle);
+    }
+
+    /// Returns whether the program started by CreateAsync has not been seen completed yet
+    bool IsCompiling() const {
+        return compiling_shader.handle != 0;
+    }
+
+    /// Checks whether the program started by CreateAsync is complete without blocking, and sets
+    /// up its bindings if it is. Returns true once the program can be used.
+    bool PollCompletion() {
+        if (!IsCompiling())
+            return true;
+
+        OGLProgram& program = boost::get<OGLProgram>(shader_or_program);
+        GLint completed = GL_FALSE;
+        glGetProgramiv(program.handle, GL_COMPLETION_STATUS_KHR, &completed);
+        if (completed != GL_TRUE)
+            return false;
+
+        GLint link_status = GL_FALSE;
+        glGetProgramiv(program.handle, GL_LINK_STATUS, &link_status);
+        if (link_status != GL_TRUE) {
+            GLint info_log_length = 0;
+            glGetProgramiv(program.handle, GL_INFO_LOG_LENGTH, &info_log_length);
+            std::string info_log(std::max(info_log_length, 1), '\0');
+            glGetProgramInfoLog(program.handle, info_log_length, nullptr, info_log.data());
+            LOG_ERROR(Render_OpenGL, "Error linking shader:\n{}", info_log);
+        }
+
+        glDetachShader(program.handle, compiling_shader.handle);
+        compiling_shader.Release();
+
+        SetShaderUniformBlockBindings(program.handle);
+        SetShaderSamplerBindings(program.handle);
+        return true;
+    }
+
     GLuint GetHandle() const {
         if (shader_or_program.which() == 0) {
             return boost::get<OGLShader>(shader_or_program).handle;
@@ -122,6 +303,51 @@ public:
 
 private:
     boost::variant<OGLShader, OGLProgram> shader_or_program;
+    /// Shader object attached to the program while it is compiled asynchronously
+    OGLShader compiling_shader;
+};
+
+/**
+ * Creates a shader stage from a program binary of the disk cache if one is given and accepted by
+ * the driver, otherwise from the GLSL code. Programs compiled from GLSL are written back to the
+ * disk cache as binaries.
+ */
+static void CreateShaderStage(OGLShaderStage& stage, const std::string& code, GLenum type,
+                              ShaderDiskCache& disk_cache,
+                              const ShaderDiskCacheBinary* binary = nullptr) {
+    if (binary != nullptr && stage.CreateFromBinary(*binary))
+        return;
+
+    stage.Create(code.c_str(), type);
+    disk_cache.SaveBinary(code, stage.GetHandle());
+}
+
+template <typename KeyConfigType>
+static std::vector<u8> GetKeyBytes(const KeyConfigType& config) {
+    const u8* state = reinterpret_cast<const u8*>(&config.state);
+    return {state, state + sizeof(config.state)};
+}
+
+template <typename KeyConfigType>
+static bool SetKeyBytes(KeyConfigType& config, const std::vector<u8>& key) {
+    if (key.size() != sizeof(config.state))
+        return false;
+    std::memcpy(&config.state, key.data(), key.size());
+    return true;
+}
+
+class UberFragmentShader {
+public:
+    explicit UberFragmentShader(bool separable) : program(separable) {
+        program.Create(GLShader::GenerateUberFragmentShader(separable).c_str(),
+                       GL_FRAGMENT_SHADER);
+    }
+    GLuint Get() const {
+        return program.GetHandle();
+    }
+
+private:
+    OGLShaderStage program;
 };
 
 class TrivialVertexShader {
@@ -138,22 +364,63 @@ private:
 };
 
 template <typename KeyConfigType, std::string (*CodeGenerator)(const KeyConfigType&, bool),
-          GLenum ShaderType>
+          GLenum ShaderType, ShaderDiskCacheType CacheType>
 class ShaderCache {
 public:
-    explicit ShaderCache(bool separable) : separable(separable) {}
+    ShaderCache(bool separable, ShaderDiskCache& disk_cache)
+        : separable(separable), disk_cache(disk_cache) {}
     GLuint Get(const KeyConfigType& config) {
         auto [iter, new_shader] = shaders.emplace(config, OGLShaderStage{separable});
         OGLShaderStage& cached_shader = iter->second;
         if (new_shader) {
-            cached_shader.Create(CodeGenerator(config, separable).c_str(), ShaderType);
+            std::string code = CodeGenerator(config, separable);
+            CreateShaderStage(cached_shader, code, ShaderType, disk_cache);
+            disk_cache.SaveEntry({CacheType, GetKeyBytes(config), std::move(code)});
         }
         return cached_shader.GetHandle();
     }
 
+    /// Returns the shader for the config if it is ready to be used. Otherwise returns 0, and starts
+    /// compiling the shader in the background if this is the first request for the config.
+    GLuint TryGet(const KeyConfigType& config) {
+        auto [iter, new_shader] = shaders.emplace(config, OGLShaderStage{separable});
+        OGLShaderStage& cached_shader = iter->second;
+        if (new_shader) {
+            std::string code = CodeGenerator(config, separable);
+            cached_shader.CreateAsync(code.c_str(), ShaderType);
+            disk_cache.SaveEntry({CacheType, GetKeyBytes(config), code});
+            compiling_code.emplace(config, std::move(code));
+            return 0;
+        }
+
+        if (cached_shader.IsCompiling()) {
+            if (!cached_shader.PollCompletion())
+                return 0;
+
+            auto code_it = compiling_code.find(config);
+            disk_cache.SaveBinary(code_it->second, cached_shader.GetHandle());
+            compiling_code.erase(code_it);
+        }
+        return cached_shader.GetHandle();
+    }
+
+    /// Adds a shader loaded from the disk cache
+    void Inject(const ShaderDiskCacheEntry& entry, const ShaderDiskCacheBinary* binary) {
+        KeyConfigType config;
+        if (!SetKeyBytes(config, entry.key))
+            return;
+        auto [iter, new_shader] = shaders.emplace(config, OGLShaderStage{separable});
+        if (new_shader) {
+            CreateShaderStage(iter->second, entry.code, ShaderType, disk_cache, binary);
+        }
+    }
+
 private:
     bool separable;
+    ShaderDiskCache& disk_cache;
     std::unordered_map<KeyConfigType, OGLShaderStage> shaders;
+    /// GLSL of the shaders being compiled asynchronously, kept to store their binaries
+    std::unordered_map<KeyConfigType, std::string> compiling_code;
 };
 
 // This is a cache designed for shaders translated from PICA shaders. The first cache matches the
@@ -164,10 +431,11 @@ private:
 template <typename KeyConfigType,
           std::optional<std::string> (*CodeGenerator)(const Pica::Shader::ShaderSetup&,
                                                       const KeyConfigType&, bool),
-          GLenum ShaderType>
+          GLenum ShaderType, ShaderDiskCacheType CacheType>
 class ShaderDoubleCache {
 public:
-    explicit ShaderDoubleCache(bool separable) : separable(separable) {}
+    ShaderDoubleCache(bool separable, ShaderDiskCache& disk_cache)
+        : separable(separable), disk_cache(disk_cache) {}
     GLuint Get(const KeyConfigType& key, const Pica::Shader::ShaderSetup& setup) {
         auto map_it = shader_map.find(key);
         if (map_it == shader_map.end()) {
@@ -181,8 +449,9 @@ public:
             auto [iter, new_shader] = shader_cache.emplace(program, OGLShaderStage{separable});
             OGLShaderStage& cached_shader = iter->second;
             if (new_shader) {
-                cached_shader.Create(program.c_str(), ShaderType);
+                CreateShaderStage(cached_shader, program, ShaderType, disk_cache);
             }
+            disk_cache.SaveEntry({CacheType, GetKeyBytes(key), program});
             shader_map[key] = &cached_shader;
             return cached_shader.GetHandle();
         }
@@ -194,34 +463,110 @@ public:
         return map_it->second->GetHandle();
     }
 
+    /// Adds a shader loaded from the disk cache
+    void Inject(const ShaderDiskCacheEntry& entry, const ShaderDiskCacheBinary* binary) {
+        KeyConfigType key;
+        if (!SetKeyBytes(key, entry.key))
+            return;
+        auto [iter, new_shader] = shader_cache.emplace(entry.code, OGLShaderStage{separable});
+        if (new_shader) {
+            CreateShaderStage(iter->second, entry.code, ShaderType, disk_cache, binary);
+        }
+        shader_map[key] = &iter->second;
+    }
+
 private:
     bool separable;
+    ShaderDiskCache& disk_cache;
     std::unordered_map<KeyConfigType, OGLShaderStage*> shader_map;
     std::unordered_map<std::string, OGLShaderStage> shader_cache;
 };
 
 using ProgrammableVertexShaders =
-    ShaderDoubleCache<GLShader::PicaVSConfig, &GLShader::GenerateVertexShader, GL_VERTEX_SHADER>;
+    ShaderDoubleCache<GLShader::PicaVSConfig, &GLShader::GenerateVertexShader, GL_VERTEX_SHADER,
+                      ShaderDiskCacheType::ProgrammableVertex>;
 
 using ProgrammableGeometryShaders =
     ShaderDoubleCache<GLShader::PicaGSConfig, &GLShader::GenerateGeometryShader,
-                      GL_GEOMETRY_SHADER>;
+                      GL_GEOMETRY_SHADER, ShaderDiskCacheType::ProgrammableGeometry>;
 
 using FixedGeometryShaders =
     ShaderCache<GLShader::PicaFixedGSConfig, &GLShader::GenerateFixedGeometryShader,
-                GL_GEOMETRY_SHADER>;
+                GL_GEOMETRY_SHADER, ShaderDiskCacheType::FixedGeometry>;
 
-using FragmentShaders =
-    ShaderCache<GLShader::PicaFSConfig, &GLShader::GenerateFragmentShader, GL_FRAGMENT_SHADER>;
+using FragmentShaders = ShaderCache<GLShader::PicaFSConfig, &GLShader::GenerateFragmentShader,
+                                    GL_FRAGMENT_SHADER, ShaderDiskCacheType::Fragment>;
 
 class ShaderProgramManager::Impl {
 public:
-    explicit Impl(bool separable, bool is_amd)
-        : is_amd(is_amd), separable(separable), programmable_vertex_shaders(separable),
-          trivial_vertex_shader(separable), programmable_geometry_shaders(separable),
-          fixed_geometry_shaders(separable), fragment_shaders(separable) {
+    Impl(bool separable, bool is_amd, u64 title_id, bool async_fragment_shaders,
+         bool use_uber_shader)
+        : is_amd(is_amd), disk_cache(title_id, separable), separable(separable),
+          use_uber_shader(use_uber_shader), programmable_vertex_shaders(separable, disk_cache),
+          trivial_vertex_shader(separable), programmable_geometry_shaders(separable, disk_cache),
+          fixed_geometry_shaders(separable, disk_cache), fragment_shaders(separable, disk_cache) {
         if (separable)
             pipeline.Create();
+        LoadDiskCache();
+
+        if (use_uber_shader) {
+            uber_fragment_shader.emplace(separable);
+        } else if (async_fragment_shaders) {
+            InitAsyncFragmentShaders();
+        }
+    }
+
+    /// Enables compiling fragment shaders in the background, which relies on the driver's own
+    /// compiler threads as the GL context can't be shared with worker threads
+    void InitAsyncFragmentShaders() {
+        if (!separable ||
+            !(GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile)) {
+            LOG_WARNING(Render_OpenGL, "Asynchronous shader compilation is not supported by the "
+                                       "driver, shaders are compiled on first use");
+            return;
+        }
+
+        // Let the driver pick the number of compiler threads
+        if (GLAD_GL_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        } else {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        }
+        uber_fragment_shader.emplace(separable);
+    }
+
+    /// Builds all shaders stored in the disk cache, so that they don't stall the first draw
+    void LoadDiskCache() {
+        const auto entries = disk_cache.LoadEntries();
+        const auto binaries = disk_cache.LoadBinaries();
+
+        for (const ShaderDiskCacheEntry& entry : entries) {
+            const auto binary_it =
+                binaries.find(Common::ComputeHash64(entry.code.data(), entry.code.size()));
+            const ShaderDiskCacheBinary* binary =
+                binary_it != binaries.end() ? &binary_it->second : nullptr;
+
+            switch (entry.type) {
+            case ShaderDiskCacheType::ProgrammableVertex:
+                programmable_vertex_shaders.Inject(entry, binary);
+                break;
+            case ShaderDiskCacheType::ProgrammableGeometry:
+                programmable_geometry_shaders.Inject(entry, binary);
+                break;
+            case ShaderDiskCacheType::FixedGeometry:
+                fixed_geometry_shaders.Inject(entry, binary);
+                break;
+            case ShaderDiskCacheType::Fragment:
+                // Specialized fragment shaders are never used in uber shader mode
+                if (!use_uber_shader)
+                    fragment_shaders.Inject(entry, binary);
+                break;
+            default:
+                LOG_ERROR(Render_OpenGL, "Unknown shader cache entry type {}",
+                          static_cast<u32>(entry.type));
+                break;
+            }
+        }
     }
 
     struct ShaderTuple {
@@ -250,6 +595,12 @@ public:
 
     bool is_amd;
 
+    ShaderDiskCache disk_cache;
+
+    bool separable;
+    /// Whether the uber fragment shader is used for all draws
+    bool use_uber_shader;
+
     ShaderTuple current;
 
     ProgrammableVertexShaders programmable_vertex_shaders;
@@ -259,14 +610,18 @@ public:
     FixedGeometryShaders fixed_geometry_shaders;
 
     FragmentShaders fragment_shaders;
+    std::optional<UberFragmentShader> uber_fragment_shader;
+    /// Config of the fragment shader being compiled while the uber fragment shader is used
+    std::optional<GLShader::PicaFSConfig> pending_fragment_config;
 
-    bool separable;
     std::unordered_map<ShaderTuple, OGLProgram, ShaderTuple::Hash> program_cache;
     OGLPipeline pipeline;
 };
 
-ShaderProgramManager::ShaderProgramManager(bool separable, bool is_amd)
-    : impl(std::make_unique<Impl>(separable, is_amd)) {}
+ShaderProgramManager::ShaderProgramManager(bool separable, bool is_amd, u64 title_id,
+                                           bool async_fragment_shaders, bool use_uber_shader)
+    : impl(std::make_unique<Impl>(separable, is_amd, title_id, async_fragment_shaders,
+                                  use_uber_shader)) {}
 
 ShaderProgramManager::~ShaderProgramManager() = default;
 
@@ -300,11 +655,42 @@ void ShaderProgramManager::UseTrivialGeometryShader() {
     impl->current.gs = 0;
 }
 
-void ShaderProgramManager::UseFragmentShader(const GLShader::PicaFSConfig& config) {
-    impl->current.fs = impl->fragment_shaders.Get(config);
+bool ShaderProgramManager::UseFragmentShader(const GLShader::PicaFSConfig& config) {
+    impl->pending_fragment_config.reset();
+    if (impl->use_uber_shader) {
+        impl->current.fs = impl->uber_fragment_shader->Get();
+        return false;
+    }
+
+    if (!impl->uber_fragment_shader) {
+        impl->current.fs = impl->fragment_shaders.Get(config);
+        return true;
+    }
+
+    GLuint handle = impl->fragment_shaders.TryGet(config);
+    if (handle == 0) {
+        impl->pending_fragment_config = config;
+        impl->current.fs = impl->uber_fragment_shader->Get();
+        return false;
+    }
+    impl->current.fs = handle;
+    return true;
+}
+
+bool ShaderProgramManager::IsUsingUberShader() const {
+    return impl->uber_fragment_shader && impl->current.fs == impl->uber_fragment_shader->Get();
 }
 
 void ShaderProgramManager::ApplyTo(OpenGLState& state) {
+    if (impl->pending_fragment_config) {
+        // Swap in the specialized shader as soon as it is ready
+        GLuint handle = impl->fragment_shaders.TryGet(*impl->pending_fragment_config);
+        if (handle != 0) {
+            impl->current.fs = handle;
+            impl->pending_fragment_config.reset();
+        }
+    }
+
     if (impl->separable) {
         if (impl->is_amd) {
             // Without this reseting, AMD sometimes freezes when one stage is changed but not for
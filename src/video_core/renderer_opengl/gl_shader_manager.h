@@ -11,7 +11,7 @@
 #include "video_core/renderer_opengl/gl_shader_gen.h"
 #include "video_core/renderer_opengl/pica_to_gl.h"
 
-enum class UniformBindings : GLuint { Common, VS, GS };
+enum class UniformBindings : GLuint { Common, VS, GS, Uber };
 
 struct LightSrc {
     alignas(16) GLvec3 specular_0;
@@ -96,10 +96,88 @@ static_assert(
 static_assert(sizeof(GSUniformData) < 16384,
               "GSUniformData structure must be less than 16kb as per the OpenGL spec");
 
+/// Uniform struct for the Uniform Buffer Object that contains the PicaFSConfig state read by the
+/// uber fragment shader. Enable flags that depend on the lighting configuration are resolved on the
+/// CPU.
+// NOTE: the same rule from UniformData also applies here.
+struct UberShaderUniformData {
+    void SetFromConfig(const GLShader::PicaFSConfig& config);
+
+    /// Bits of the flags component of lighting_lights
+    enum LightFlags : GLint {
+        LightDirectional = 1 << 0,
+        LightTwoSidedDiffuse = 1 << 1,
+        LightDistAtten = 1 << 2,
+        LightSpotAtten = 1 << 3,
+        LightGeometricFactor0 = 1 << 4,
+        LightGeometricFactor1 = 1 << 5,
+        LightShadow = 1 << 6,
+        LightTwoSidedLut = 1 << 7,
+    };
+
+    struct LightingLut {
+        GLint enable;
+        GLint abs_input;
+        GLint type;
+        GLfloat scale;
+    };
+
+    GLint alpha_test_func;
+    GLint scissor_test_mode;
+    GLint texture0_type;
+    GLint texture2_use_coord1;
+    GLint combiner_buffer_input;
+    GLint depthmap_enable;
+    GLint fog_mode;
+    GLint fog_flip;
+    GLint lighting_enable;
+    GLint lighting_src_num;
+    GLint lighting_config;
+    GLint lighting_bump_mode;
+    GLint lighting_bump_selector;
+    GLint lighting_bump_renorm;
+    GLint lighting_clamp_highlights;
+    GLint lighting_enable_primary_alpha;
+    GLint lighting_enable_secondary_alpha;
+    GLint lighting_enable_shadow;
+    GLint lighting_shadow_primary;
+    GLint lighting_shadow_secondary;
+    GLint lighting_shadow_invert;
+    GLint lighting_shadow_alpha;
+    GLint lighting_shadow_selector;
+    GLint proctex_enable;
+    GLint proctex_coord;
+    GLint proctex_u_clamp;
+    GLint proctex_v_clamp;
+    GLint proctex_color_combiner;
+    GLint proctex_alpha_combiner;
+    GLint proctex_separate_alpha;
+    GLint proctex_noise_enable;
+    GLint proctex_u_shift;
+    GLint proctex_v_shift;
+    GLint proctex_lut_width;
+    GLint proctex_lut_filter;
+    GLfloat proctex_lod_min;
+    GLfloat proctex_lod_max;
+    GLint shadow_rendering;
+    GLint shadow_texture_orthographic;
+    GLint shadow_texture_bias;
+    alignas(16) GLivec4 proctex_lut_offsets; // offsets of the color LUT levels 0-3
+    alignas(16) GLuvec4 tev_stages[6]; // sources, modifiers, ops and scales of each stage
+    alignas(16) GLivec4 lighting_lights[8]; // light index and LightFlags of each light slot
+    alignas(16) LightingLut lighting_luts[7]; // D0, D1, SP, FR, RR, RG, RB
+};
+static_assert(sizeof(UberShaderUniformData) == 0x200,
+              "The size of the UberShaderUniformData structure has changed, update the structure "
+              "in the shader");
+static_assert(sizeof(UberShaderUniformData) < 16384,
+              "UberShaderUniformData structure must be less than 16kb as per the OpenGL spec");
+
 /// A class that manage different shader stages and configures them with given config data.
 class ShaderProgramManager {
 public:
-    ShaderProgramManager(bool separable, bool is_amd);
+    ShaderProgramManager(bool separable, bool is_amd, u64 title_id, bool async_fragment_shaders,
+                         bool use_uber_shader);
     ~ShaderProgramManager();
 
     bool UseProgrammableVertexShader(const GLShader::PicaVSConfig& config,
@@ -114,7 +192,17 @@ public:
 
     void UseTrivialGeometryShader();
 
-    void UseFragmentShader(const GLShader::PicaFSConfig& config);
+    /**
+     * Selects the fragment shader for the given config. In uber shader mode, or when asynchronous
+     * compilation is enabled and the shader is not ready yet, the uber fragment shader is selected
+     * in its place.
+     * @returns false if the uber fragment shader is used, it then has to be configured through
+     *          UberShaderUniformData
+     */
+    bool UseFragmentShader(const GLShader::PicaFSConfig& config);
+
+    /// Returns whether the uber fragment shader is selected
+    bool IsUsingUberShader() const;
 
     void ApplyTo(OpenGLState& state);
 
@@ -22,6 +22,9 @@ GLuint LoadShader(const char* source, GLenum type) {
     case GL_FRAGMENT_SHADER:
         debug_type = "fragment";
         break;
+    case GL_COMPUTE_SHADER:
+        debug_type = "compute";
+        break;
     default:
         UNREACHABLE();
     }
@@ -64,6 +67,10 @@ GLuint LoadProgram(bool separable_program, const std::vector<GLuint>& shaders) {
 
     if (separable_program) {
         glProgramParameteri(program_id, GL_PROGRAM_SEPARABLE, GL_TRUE);
+        if (GLAD_GL_ARB_get_program_binary) {
+            // Allows storing the program in the disk shader cache
+            glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
     }
 
     glLinkProgram(program_id);
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include <glad/glad.h>
 #include "common/common_funcs.h"
 #include "common/logging/log.h"
@@ -9,6 +10,24 @@
 
 OpenGLState OpenGLState::cur_state;
 
+namespace {
+
+/// Compares a state group bytewise. Differing padding bytes are harmless, they only result in the
+/// group being compared field by field
+template <typename T>
+bool Changed(const T& group, const T& cur_group) {
+    return std::memcmp(&group, &cur_group, sizeof(T)) != 0;
+}
+
+/// glBindTextureUnit is not used, as it fails for texture names from glGenTextures that were never
+/// bound to a target, which is how textures are created
+void BindTexture(TextureUnits::TextureUnit unit, GLenum target, GLuint texture) {
+    glActiveTexture(unit.Enum());
+    glBindTexture(target, texture);
+}
+
+} // anonymous namespace
+
 OpenGLState::OpenGLState() {
     // These all match default OpenGL values
     cull.enabled = false;
@@ -89,106 +108,115 @@ OpenGLState::OpenGLState() {
 }
 
 void OpenGLState::Apply() const {
+    // Apply is called several times per draw, usually with no or very few changes
+    if (!Changed(*this, cur_state))
+        return;
+
     // Culling
-    if (cull.enabled != cur_state.cull.enabled) {
-        if (cull.enabled) {
-            glEnable(GL_CULL_FACE);
-        } else {
-            glDisable(GL_CULL_FACE);
+    if (Changed(cull, cur_state.cull)) {
+        if (cull.enabled != cur_state.cull.enabled) {
+            if (cull.enabled) {
+                glEnable(GL_CULL_FACE);
+            } else {
+                glDisable(GL_CULL_FACE);
+            }
         }
-    }
 
-    if (cull.mode != cur_state.cull.mode) {
-        glCullFace(cull.mode);
-    }
+        if (cull.mode != cur_state.cull.mode) {
+            glCullFace(cull.mode);
+        }
 
-    if (cull.front_face != cur_state.cull.front_face) {
-        glFrontFace(cull.front_face);
+        if (cull.front_face != cur_state.cull.front_face) {
+            glFrontFace(cull.front_face);
+        }
     }
 
-    // Depth test
-    if (depth.test_enabled != cur_state.depth.test_enabled) {
-        if (depth.test_enabled) {
-            glEnable(GL_DEPTH_TEST);
-        } else {
-            glDisable(GL_DEPTH_TEST);
+    if (Changed(depth, cur_state.depth)) {
+        // Depth test
+        if (depth.test_enabled != cur_state.depth.test_enabled) {
+            if (depth.test_enabled) {
+                glEnable(GL_DEPTH_TEST);
+            } else {
+                glDisable(GL_DEPTH_TEST);
+            }
         }
-    }
 
-    if (depth.test_func != cur_state.depth.test_func) {
-        glDepthFunc(depth.test_func);
-    }
+        if (depth.test_func != cur_state.depth.test_func) {
+            glDepthFunc(depth.test_func);
+        }
 
-    // Depth mask
-    if (depth.write_mask != cur_state.depth.write_mask) {
-        glDepthMask(depth.write_mask);
+        // Depth mask
+        if (depth.write_mask != cur_state.depth.write_mask) {
+            glDepthMask(depth.write_mask);
+        }
     }
 
     // Color mask
-    if (color_mask.red_enabled != cur_state.color_mask.red_enabled ||
-        color_mask.green_enabled != cur_state.color_mask.green_enabled ||
-        color_mask.blue_enabled != cur_state.color_mask.blue_enabled ||
-        color_mask.alpha_enabled != cur_state.color_mask.alpha_enabled) {
+    if (Changed(color_mask, cur_state.color_mask)) {
         glColorMask(color_mask.red_enabled, color_mask.green_enabled, color_mask.blue_enabled,
                     color_mask.alpha_enabled);
     }
 
-    // Stencil test
-    if (stencil.test_enabled != cur_state.stencil.test_enabled) {
-        if (stencil.test_enabled) {
-            glEnable(GL_STENCIL_TEST);
-        } else {
-            glDisable(GL_STENCIL_TEST);
+    if (Changed(stencil, cur_state.stencil)) {
+        // Stencil test
+        if (stencil.test_enabled != cur_state.stencil.test_enabled) {
+            if (stencil.test_enabled) {
+                glEnable(GL_STENCIL_TEST);
+            } else {
+                glDisable(GL_STENCIL_TEST);
+            }
         }
-    }
 
-    if (stencil.test_func != cur_state.stencil.test_func ||
-        stencil.test_ref != cur_state.stencil.test_ref ||
-        stencil.test_mask != cur_state.stencil.test_mask) {
-        glStencilFunc(stencil.test_func, stencil.test_ref, stencil.test_mask);
-    }
+        if (stencil.test_func != cur_state.stencil.test_func ||
+            stencil.test_ref != cur_state.stencil.test_ref ||
+            stencil.test_mask != cur_state.stencil.test_mask) {
+            glStencilFunc(stencil.test_func, stencil.test_ref, stencil.test_mask);
+        }
 
-    if (stencil.action_depth_fail != cur_state.stencil.action_depth_fail ||
-        stencil.action_depth_pass != cur_state.stencil.action_depth_pass ||
-        stencil.action_stencil_fail != cur_state.stencil.action_stencil_fail) {
-        glStencilOp(stencil.action_stencil_fail, stencil.action_depth_fail,
-                    stencil.action_depth_pass);
-    }
+        if (stencil.action_depth_fail != cur_state.stencil.action_depth_fail ||
+            stencil.action_depth_pass != cur_state.stencil.action_depth_pass ||
+            stencil.action_stencil_fail != cur_state.stencil.action_stencil_fail) {
+            glStencilOp(stencil.action_stencil_fail, stencil.action_depth_fail,
+                        stencil.action_depth_pass);
+        }
 
-    // Stencil mask
-    if (stencil.write_mask != cur_state.stencil.write_mask) {
-        glStencilMask(stencil.write_mask);
+        // Stencil mask
+        if (stencil.write_mask != cur_state.stencil.write_mask) {
+            glStencilMask(stencil.write_mask);
+        }
     }
 
     // Blending
-    if (blend.enabled != cur_state.blend.enabled) {
-        if (blend.enabled) {
-            glEnable(GL_BLEND);
-            glDisable(GL_COLOR_LOGIC_OP);
-        } else {
-            glDisable(GL_BLEND);
-            glEnable(GL_COLOR_LOGIC_OP);
+    if (Changed(blend, cur_state.blend)) {
+        if (blend.enabled != cur_state.blend.enabled) {
+            if (blend.enabled) {
+                glEnable(GL_BLEND);
+                glDisable(GL_COLOR_LOGIC_OP);
+            } else {
+                glDisable(GL_BLEND);
+                glEnable(GL_COLOR_LOGIC_OP);
+            }
         }
-    }
 
-    if (blend.color.red != cur_state.blend.color.red ||
-        blend.color.green != cur_state.blend.color.green ||
-        blend.color.blue != cur_state.blend.color.blue ||
-        blend.color.alpha != cur_state.blend.color.alpha) {
-        glBlendColor(blend.color.red, blend.color.green, blend.color.blue, blend.color.alpha);
-    }
+        if (blend.color.red != cur_state.blend.color.red ||
+            blend.color.green != cur_state.blend.color.green ||
+            blend.color.blue != cur_state.blend.color.blue ||
+            blend.color.alpha != cur_state.blend.color.alpha) {
+            glBlendColor(blend.color.red, blend.color.green, blend.color.blue, blend.color.alpha);
+        }
 
-    if (blend.src_rgb_func != cur_state.blend.src_rgb_func ||
-        blend.dst_rgb_func != cur_state.blend.dst_rgb_func ||
-        blend.src_a_func != cur_state.blend.src_a_func ||
-        blend.dst_a_func != cur_state.blend.dst_a_func) {
-        glBlendFuncSeparate(blend.src_rgb_func, blend.dst_rgb_func, blend.src_a_func,
-                            blend.dst_a_func);
-    }
+        if (blend.src_rgb_func != cur_state.blend.src_rgb_func ||
+            blend.dst_rgb_func != cur_state.blend.dst_rgb_func ||
+            blend.src_a_func != cur_state.blend.src_a_func ||
+            blend.dst_a_func != cur_state.blend.dst_a_func) {
+            glBlendFuncSeparate(blend.src_rgb_func, blend.dst_rgb_func, blend.src_a_func,
+                                blend.dst_a_func);
+        }
 
-    if (blend.rgb_equation != cur_state.blend.rgb_equation ||
-        blend.a_equation != cur_state.blend.a_equation) {
-        glBlendEquationSeparate(blend.rgb_equation, blend.a_equation);
+        if (blend.rgb_equation != cur_state.blend.rgb_equation ||
+            blend.a_equation != cur_state.blend.a_equation) {
+            glBlendEquationSeparate(blend.rgb_equation, blend.a_equation);
+        }
     }
 
     if (logic_op != cur_state.logic_op) {
@@ -196,19 +224,20 @@ void OpenGLState::Apply() const {
     }
 
     // Textures
-    for (unsigned i = 0; i < ARRAY_SIZE(texture_units); ++i) {
-        if (texture_units[i].texture_2d != cur_state.texture_units[i].texture_2d) {
-            glActiveTexture(TextureUnits::PicaTexture(i).Enum());
-            glBindTexture(GL_TEXTURE_2D, texture_units[i].texture_2d);
-        }
-        if (texture_units[i].sampler != cur_state.texture_units[i].sampler) {
-            glBindSampler(i, texture_units[i].sampler);
+    if (Changed(texture_units, cur_state.texture_units)) {
+        for (unsigned i = 0; i < ARRAY_SIZE(texture_units); ++i) {
+            if (texture_units[i].texture_2d != cur_state.texture_units[i].texture_2d) {
+                BindTexture(TextureUnits::PicaTexture(i), GL_TEXTURE_2D,
+                            texture_units[i].texture_2d);
+            }
+            if (texture_units[i].sampler != cur_state.texture_units[i].sampler) {
+                glBindSampler(i, texture_units[i].sampler);
+            }
         }
     }
 
     if (texture_cube_unit.texture_cube != cur_state.texture_cube_unit.texture_cube) {
-        glActiveTexture(TextureUnits::TextureCube.Enum());
-        glBindTexture(GL_TEXTURE_CUBE_MAP, texture_cube_unit.texture_cube);
+        BindTexture(TextureUnits::TextureCube, GL_TEXTURE_CUBE_MAP, texture_cube_unit.texture_cube);
     }
     if (texture_cube_unit.sampler != cur_state.texture_cube_unit.sampler) {
         glBindSampler(TextureUnits::TextureCube.id, texture_cube_unit.sampler);
@@ -216,15 +245,15 @@ void OpenGLState::Apply() const {
 
     // Texture buffer LUTs
     if (texture_buffer_lut_rg.texture_buffer != cur_state.texture_buffer_lut_rg.texture_buffer) {
-        glActiveTexture(TextureUnits::TextureBufferLUT_RG.Enum());
-        glBindTexture(GL_TEXTURE_BUFFER, texture_buffer_lut_rg.texture_buffer);
+        BindTexture(TextureUnits::TextureBufferLUT_RG, GL_TEXTURE_BUFFER,
+                    texture_buffer_lut_rg.texture_buffer);
     }
 
     // Texture buffer LUTs
     if (texture_buffer_lut_rgba.texture_buffer !=
         cur_state.texture_buffer_lut_rgba.texture_buffer) {
-        glActiveTexture(TextureUnits::TextureBufferLUT_RGBA.Enum());
-        glBindTexture(GL_TEXTURE_BUFFER, texture_buffer_lut_rgba.texture_buffer);
+        BindTexture(TextureUnits::TextureBufferLUT_RGBA, GL_TEXTURE_BUFFER,
+                    texture_buffer_lut_rgba.texture_buffer);
     }
 
     // Shadow Images
@@ -263,37 +292,39 @@ void OpenGLState::Apply() const {
                            GL_READ_ONLY, GL_R32UI);
     }
 
-    // Framebuffer
-    if (draw.read_framebuffer != cur_state.draw.read_framebuffer) {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, draw.read_framebuffer);
-    }
-    if (draw.draw_framebuffer != cur_state.draw.draw_framebuffer) {
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw.draw_framebuffer);
-    }
+    if (Changed(draw, cur_state.draw)) {
+        // Framebuffer
+        if (draw.read_framebuffer != cur_state.draw.read_framebuffer) {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, draw.read_framebuffer);
+        }
+        if (draw.draw_framebuffer != cur_state.draw.draw_framebuffer) {
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw.draw_framebuffer);
+        }
 
-    // Vertex array
-    if (draw.vertex_array != cur_state.draw.vertex_array) {
-        glBindVertexArray(draw.vertex_array);
-    }
+        // Vertex array
+        if (draw.vertex_array != cur_state.draw.vertex_array) {
+            glBindVertexArray(draw.vertex_array);
+        }
 
-    // Vertex buffer
-    if (draw.vertex_buffer != cur_state.draw.vertex_buffer) {
-        glBindBuffer(GL_ARRAY_BUFFER, draw.vertex_buffer);
-    }
+        // Vertex buffer
+        if (draw.vertex_buffer != cur_state.draw.vertex_buffer) {
+            glBindBuffer(GL_ARRAY_BUFFER, draw.vertex_buffer);
+        }
 
-    // Uniform buffer
-    if (draw.uniform_buffer != cur_state.draw.uniform_buffer) {
-        glBindBuffer(GL_UNIFORM_BUFFER, draw.uniform_buffer);
-    }
+        // Uniform buffer
+        if (draw.uniform_buffer != cur_state.draw.uniform_buffer) {
+            glBindBuffer(GL_UNIFORM_BUFFER, draw.uniform_buffer);
+        }
 
-    // Shader program
-    if (draw.shader_program != cur_state.draw.shader_program) {
-        glUseProgram(draw.shader_program);
-    }
+        // Shader program
+        if (draw.shader_program != cur_state.draw.shader_program) {
+            glUseProgram(draw.shader_program);
+        }
 
-    // Program pipeline
-    if (draw.program_pipeline != cur_state.draw.program_pipeline) {
-        glBindProgramPipeline(draw.program_pipeline);
+        // Program pipeline
+        if (draw.program_pipeline != cur_state.draw.program_pipeline) {
+            glBindProgramPipeline(draw.program_pipeline);
+        }
     }
 
     // Scissor test
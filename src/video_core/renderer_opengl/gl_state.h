@@ -34,6 +34,7 @@ constexpr GLuint ShadowTexturePY = 3;
 constexpr GLuint ShadowTextureNY = 4;
 constexpr GLuint ShadowTexturePZ = 5;
 constexpr GLuint ShadowTextureNZ = 6;
+constexpr GLuint TextureDecode = 7;
 } // namespace ImageUnits
 
 class OpenGLState {
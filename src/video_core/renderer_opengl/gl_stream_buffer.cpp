@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <deque>
 #include <vector>
 #include "common/alignment.h"
@@ -33,6 +34,8 @@ OGLStreamBuffer::OGLStreamBuffer(GLenum target, GLsizeiptr size, bool array_buff
         glBufferStorage(gl_target, allocate_size, nullptr, flags);
         mapped_ptr = static_cast<u8*>(glMapBufferRange(
             gl_target, 0, buffer_size, flags | (coherent ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT)));
+        region_size = static_cast<GLsizeiptr>(
+            Common::AlignUp<std::size_t>(buffer_size, NUM_SYNCS) / NUM_SYNCS);
     } else {
         glBufferData(gl_target, allocate_size, nullptr, GL_STREAM_DRAW);
     }
@@ -64,25 +67,35 @@ std::tuple<u8*, GLintptr, bool> OGLStreamBuffer::Map(GLsizeiptr size, GLintptr a
     }
 
     bool invalidate = false;
+    if (persistent) {
+        // The chunks returned so far have been consumed by the commands issued since then. The
+        // alignment may have moved the position past the end of the buffer.
+        FenceRegions(std::min<std::size_t>(buffer_pos / region_size, NUM_SYNCS));
+        if (buffer_pos + size > buffer_size) {
+            FenceRegions(NUM_SYNCS);
+            fenced_regions = 0;
+            buffer_pos = 0;
+            invalidate = true;
+        }
+
+        // Instead of reallocating the buffer, only wait for the GPU to be done with the memory
+        // that is about to be overwritten
+        WaitForRegions(buffer_pos, buffer_pos + size);
+        return std::make_tuple(mapped_ptr + buffer_pos, buffer_pos, invalidate);
+    }
+
     if (buffer_pos + size > buffer_size) {
         buffer_pos = 0;
         invalidate = true;
-
-        if (persistent) {
-            glUnmapBuffer(gl_target);
-        }
     }
 
-    if (invalidate || !persistent) {
-        GLbitfield flags = GL_MAP_WRITE_BIT | (persistent ? GL_MAP_PERSISTENT_BIT : 0) |
-                           (coherent ? GL_MAP_COHERENT_BIT : GL_MAP_FLUSH_EXPLICIT_BIT) |
-                           (invalidate ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_UNSYNCHRONIZED_BIT);
-        mapped_ptr = static_cast<u8*>(
-            glMapBufferRange(gl_target, buffer_pos, buffer_size - buffer_pos, flags));
-        mapped_offset = buffer_pos;
-    }
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT |
+                       (invalidate ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_UNSYNCHRONIZED_BIT);
+    mapped_ptr = static_cast<u8*>(
+        glMapBufferRange(gl_target, buffer_pos, buffer_size - buffer_pos, flags));
+    mapped_offset = buffer_pos;
 
-    return std::make_tuple(mapped_ptr + buffer_pos - mapped_offset, buffer_pos, invalidate);
+    return std::make_tuple(mapped_ptr, buffer_pos, invalidate);
 }
 
 void OGLStreamBuffer::Unmap(GLsizeiptr size) {
@@ -98,3 +111,27 @@ void OGLStreamBuffer::Unmap(GLsizeiptr size) {
 
     buffer_pos += size;
 }
+
+void OGLStreamBuffer::FenceRegions(std::size_t count) {
+    for (; fenced_regions < count; ++fenced_regions) {
+        // Regions that were not reused in this pass keep their older fence
+        fences[fenced_regions].Create();
+    }
+}
+
+void OGLStreamBuffer::WaitForRegions(GLintptr begin, GLintptr end) {
+    const std::size_t first = static_cast<std::size_t>(begin / region_size);
+    const std::size_t last = static_cast<std::size_t>((end + region_size - 1) / region_size);
+    for (std::size_t region = first; region < last; ++region) {
+        OGLSync& fence = fences[region];
+        if (fence.handle == nullptr)
+            continue;
+
+        GLenum result;
+        do {
+            result = glClientWaitSync(fence.handle, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                      1000000000); // 1 second
+        } while (result == GL_TIMEOUT_EXPIRED);
+        fence.Release();
+    }
+}
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <tuple>
 #include <glad/glad.h>
 #include "common/common_types.h"
@@ -21,7 +22,9 @@ public:
     /*
      * Allocates a linear chunk of memory in the GPU buffer with at least "size" bytes
      * and the optional alignment requirement.
-     * If the buffer is full, the whole buffer is reallocated which invalidates old chunks.
+     * If the buffer is full, allocation wraps around to its start which invalidates old chunks.
+     * A persistently mapped buffer waits for the GPU to finish reading the reused memory,
+     * otherwise the whole buffer is reallocated.
      * The return values are the pointer to the new chunk, the offset within the buffer,
      * and the invalidation flag for previous chunks.
      * The actual used size must be specified on unmapping the chunk.
@@ -31,6 +34,15 @@ public:
     void Unmap(GLsizeiptr size);
 
 private:
+    /// Number of fenced regions the persistently mapped buffer is divided into
+    static constexpr std::size_t NUM_SYNCS = 16;
+
+    /// Inserts fences for the regions of the current pass up to the given number
+    void FenceRegions(std::size_t count);
+
+    /// Waits for the GPU to finish reading the regions overlapping the given range
+    void WaitForRegions(GLintptr begin, GLintptr end);
+
     OGLBuffer gl_buffer;
     GLenum gl_target;
 
@@ -42,4 +54,9 @@ private:
     GLintptr mapped_offset = 0;
     GLsizeiptr mapped_size = 0;
     u8* mapped_ptr = nullptr;
+
+    GLsizeiptr region_size = 0;
+    /// Number of regions of the current pass through the buffer that are already fenced
+    std::size_t fenced_regions = 0;
+    std::array<OGLSync, NUM_SYNCS> fences;
 };
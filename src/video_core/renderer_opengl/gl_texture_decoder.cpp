@@ -0,0 +1,274 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <tuple>
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/microprofile.h"
+#include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/renderer_opengl/gl_texture_decoder.h"
+
+namespace {
+
+// The texels are decoded as in texture_decode.cpp and etc1.cpp, one invocation per texel and one
+// work group per 8x8 tile
+constexpr char decode_shader_source[] = R"(
+#version 330 core
+#extension GL_ARB_compute_shader : require
+#extension GL_ARB_shader_storage_buffer_object : require
+#extension GL_ARB_shader_image_load_store : require
+#extension GL_ARB_explicit_uniform_location : require
+#extension GL_ARB_shading_language_420pack : require
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(std430, binding = 0) readonly buffer source_data {
+    uint source[];
+};
+
+layout(binding = 7, rgba8) uniform writeonly image2D dst_image;
+
+// Format of the texture, as Pica::TexturingRegs::TextureFormat
+layout(location = 0) uniform uint format;
+// Size in bytes of a row of tiles and of a single tile
+layout(location = 1) uniform uint tile_stride;
+layout(location = 2) uniform uint tile_size;
+// Offset of source[0] from the start of the texture in bytes
+layout(location = 3) uniform uint source_base;
+// Texel decoded by the first invocation, with y pointing down as in 3DS memory
+layout(location = 4) uniform uvec2 src_origin;
+// Position of that texel in the destination image, where y points up
+layout(location = 5) uniform ivec2 dst_origin;
+
+const uint xlut[8] = uint[8](0x00u, 0x01u, 0x04u, 0x05u, 0x10u, 0x11u, 0x14u, 0x15u);
+const uint ylut[8] = uint[8](0x00u, 0x02u, 0x08u, 0x0au, 0x20u, 0x22u, 0x28u, 0x2au);
+
+const int etc1_modifier_table[16] = int[16](2, 8, 5, 17, 9, 29, 13, 42, 18, 60, 24, 80, 33, 106,
+                                            47, 183);
+
+uint ReadByte(uint address) {
+    uint offset = address - source_base;
+    return (source[offset >> 2] >> ((offset & 3u) * 8u)) & 0xFFu;
+}
+
+uint ReadU16(uint address) {
+    return ReadByte(address) | (ReadByte(address + 1u) << 8);
+}
+
+uint ReadU32(uint address) {
+    return ReadU16(address) | (ReadU16(address + 2u) << 16);
+}
+
+uint Convert4To8(uint value) {
+    return (value << 4) | value;
+}
+
+// Also wraps around like the u8 conversion on the CPU, which matters for ETC1 base colors
+uint Convert5To8(uint value) {
+    value &= 0xFFu;
+    return ((value << 3) | (value >> 2)) & 0xFFu;
+}
+
+uint Convert6To8(uint value) {
+    return (value << 2) | (value >> 4);
+}
+
+int SignExtend3(uint value) {
+    return int(value << 29) >> 29;
+}
+
+uvec4 DecodeETC1(uint tile_address, uint x, uint y, bool has_alpha) {
+    uint subtile_address = tile_address + ((x / 4u) + 2u * (y / 4u)) * (has_alpha ? 16u : 8u);
+    x %= 4u;
+    y %= 4u;
+
+    uint alpha = 255u;
+    if (has_alpha) {
+        uint nibble = x * 4u + y;
+        uint packed_alpha = ReadU32(subtile_address + (nibble / 8u) * 4u);
+        alpha = Convert4To8((packed_alpha >> ((nibble % 8u) * 4u)) & 0xFu);
+        subtile_address += 8u;
+    }
+
+    uint low = ReadU32(subtile_address);
+    uint high = ReadU32(subtile_address + 4u);
+
+    bool flip = (high & 1u) != 0u;
+    bool differential_mode = (high & 2u) != 0u;
+    uint subblock = ((flip ? y : x) < 2u) ? 0u : 1u;
+    uint table_index = (subblock == 0u) ? ((high >> 5) & 7u) : ((high >> 2) & 7u);
+
+    ivec3 base;
+    if (differential_mode) {
+        ivec3 color = ivec3((high >> 27) & 0x1Fu, (high >> 19) & 0x1Fu, (high >> 11) & 0x1Fu);
+        if (subblock != 0u) {
+            color += ivec3(SignExtend3(high >> 24), SignExtend3(high >> 16),
+                           SignExtend3(high >> 8));
+        }
+        base = ivec3(Convert5To8(uint(color.r)), Convert5To8(uint(color.g)),
+                     Convert5To8(uint(color.b)));
+    } else {
+        uint shift = (subblock == 0u) ? 4u : 0u;
+        base = ivec3(Convert4To8((high >> (24u + shift)) & 0xFu),
+                     Convert4To8((high >> (16u + shift)) & 0xFu),
+                     Convert4To8((high >> (8u + shift)) & 0xFu));
+    }
+
+    uint texel = 4u * x + y;
+    int modifier = etc1_modifier_table[table_index * 2u + ((low >> texel) & 1u)];
+    if (((low >> (16u + texel)) & 1u) != 0u) {
+        modifier = -modifier;
+    }
+
+    return uvec4(clamp(base + modifier, 0, 255), alpha);
+}
+
+uvec4 DecodeTexel(uint tile_address, uint x, uint y) {
+    if (format >= 12u) {
+        return DecodeETC1(tile_address, x, y, format == 13u);
+    }
+
+    uint morton_offset = xlut[x] + ylut[y];
+    switch (format) {
+    case 0u: { // RGBA8
+        uint address = tile_address + morton_offset * 4u;
+        return uvec4(ReadByte(address + 3u), ReadByte(address + 2u), ReadByte(address + 1u),
+                     ReadByte(address));
+    }
+    case 1u: { // RGB8
+        uint address = tile_address + morton_offset * 3u;
+        return uvec4(ReadByte(address + 2u), ReadByte(address + 1u), ReadByte(address), 255u);
+    }
+    case 2u: { // RGB5A1
+        uint pixel = ReadU16(tile_address + morton_offset * 2u);
+        return uvec4(Convert5To8((pixel >> 11) & 0x1Fu), Convert5To8((pixel >> 6) & 0x1Fu),
+                     Convert5To8((pixel >> 1) & 0x1Fu), (pixel & 1u) * 255u);
+    }
+    case 3u: { // RGB565
+        uint pixel = ReadU16(tile_address + morton_offset * 2u);
+        return uvec4(Convert5To8((pixel >> 11) & 0x1Fu), Convert6To8((pixel >> 5) & 0x3Fu),
+                     Convert5To8(pixel & 0x1Fu), 255u);
+    }
+    case 4u: { // RGBA4
+        uint pixel = ReadU16(tile_address + morton_offset * 2u);
+        return uvec4(Convert4To8((pixel >> 12) & 0xFu), Convert4To8((pixel >> 8) & 0xFu),
+                     Convert4To8((pixel >> 4) & 0xFu), Convert4To8(pixel & 0xFu));
+    }
+    case 5u: { // IA8
+        uint address = tile_address + morton_offset * 2u;
+        uint i = ReadByte(address + 1u);
+        return uvec4(i, i, i, ReadByte(address));
+    }
+    case 6u: { // RG8
+        uint address = tile_address + morton_offset * 2u;
+        return uvec4(ReadByte(address + 1u), ReadByte(address), 0u, 255u);
+    }
+    case 7u: { // I8
+        uint i = ReadByte(tile_address + morton_offset);
+        return uvec4(i, i, i, 255u);
+    }
+    case 8u: // A8
+        return uvec4(0u, 0u, 0u, ReadByte(tile_address + morton_offset));
+    case 9u: { // IA4
+        uint value = ReadByte(tile_address + morton_offset);
+        uint i = Convert4To8(value >> 4);
+        return uvec4(i, i, i, Convert4To8(value & 0xFu));
+    }
+    case 10u: { // I4
+        uint value = ReadByte(tile_address + morton_offset / 2u);
+        uint i = Convert4To8((value >> ((morton_offset % 2u) * 4u)) & 0xFu);
+        return uvec4(i, i, i, 255u);
+    }
+    default: { // A4
+        uint value = ReadByte(tile_address + morton_offset / 2u);
+        return uvec4(0u, 0u, 0u, Convert4To8((value >> ((morton_offset % 2u) * 4u)) & 0xFu));
+    }
+    }
+}
+
+void main() {
+    uvec2 position = gl_GlobalInvocationID.xy;
+    uvec2 texel = src_origin + position;
+    uint tile_address = (texel.y / 8u) * tile_stride + (texel.x / 8u) * tile_size;
+
+    uvec4 color = DecodeTexel(tile_address, texel.x % 8u, texel.y % 8u);
+    imageStore(dst_image, dst_origin + ivec2(position.x, -int(position.y)), vec4(color) / 255.0);
+}
+)";
+
+} // anonymous namespace
+
+MICROPROFILE_DEFINE(OpenGL_TextureDecode, "OpenGL", "Texture Decode", MP_RGB(128, 64, 192));
+
+ComputeTextureDecoder::ComputeTextureDecoder()
+    : source_buffer(GL_SHADER_STORAGE_BUFFER, SOURCE_BUFFER_SIZE, false) {
+    OGLShader shader;
+    shader.Create(decode_shader_source, GL_COMPUTE_SHADER);
+    program.Create(false, {shader.handle});
+
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &source_buffer_alignment);
+}
+
+bool ComputeTextureDecoder::IsSupported() {
+    return GLAD_GL_ARB_compute_shader && GLAD_GL_ARB_shader_storage_buffer_object &&
+           GLAD_GL_ARB_shader_image_load_store && GLAD_GL_ARB_explicit_uniform_location &&
+           GLAD_GL_ARB_shading_language_420pack;
+}
+
+bool ComputeTextureDecoder::Decode(const Pica::Texture::TextureInfo& info, const u8* source,
+                                   const MathUtil::Rectangle<u32>& rect, GLuint dst_texture,
+                                   GLint dst_x, GLint dst_y) {
+    const u32 tile_size = static_cast<u32>(Pica::Texture::CalculateTileSize(info.format));
+    const u32 tile_stride = static_cast<u32>(info.stride);
+
+    // Rows of tiles are stored top to bottom, while the rectangle is given bottom to top
+    const u32 src_x = rect.left;
+    const u32 src_y = info.height - rect.top;
+    const u32 first_byte = (src_y / 8) * tile_stride + (src_x / 8) * tile_size;
+    const u32 end_byte =
+        ((info.height - rect.bottom) / 8 - 1) * tile_stride + (rect.right / 8) * tile_size;
+
+    // Only whole words are read by the shader
+    const u32 source_base = Common::AlignDown(first_byte, 4);
+    const u32 copy_size = end_byte - source_base;
+    const GLsizeiptr upload_size = Common::AlignUp(copy_size, 4);
+    if (upload_size > source_buffer.GetSize())
+        return false;
+
+    MICROPROFILE_SCOPE(OpenGL_TextureDecode);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, source_buffer.GetHandle());
+    u8* buffer;
+    GLintptr offset;
+    std::tie(buffer, offset, std::ignore) = source_buffer.Map(upload_size, source_buffer_alignment);
+    std::memcpy(buffer, source + source_base, copy_size);
+    source_buffer.Unmap(upload_size);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, source_buffer.GetHandle(), offset, upload_size);
+
+    OpenGLState state = OpenGLState::GetCurState();
+    const GLuint old_program = state.draw.shader_program;
+    state.draw.shader_program = program.handle;
+    state.Apply();
+
+    glUniform1ui(0, static_cast<GLuint>(info.format));
+    glUniform1ui(1, tile_stride);
+    glUniform1ui(2, tile_size);
+    glUniform1ui(3, source_base);
+    glUniform2ui(4, src_x, src_y);
+    glUniform2i(5, dst_x, dst_y + static_cast<GLint>(rect.GetHeight()) - 1);
+
+    glBindImageTexture(ImageUnits::TextureDecode, dst_texture, 0, GL_FALSE, 0, GL_WRITE_ONLY,
+                       GL_RGBA8);
+    glDispatchCompute(rect.GetWidth() / 8, rect.GetHeight() / 8, 1);
+    glBindImageTexture(ImageUnits::TextureDecode, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+
+    // The texture is sampled, blitted or read back afterwards
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT |
+                    GL_FRAMEBUFFER_BARRIER_BIT);
+
+    state.draw.shader_program = old_program;
+    state.Apply();
+    return true;
+}
@@ -0,0 +1,46 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <glad/glad.h>
+#include "common/common_types.h"
+#include "common/math_util.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+#include "video_core/renderer_opengl/gl_stream_buffer.h"
+#include "video_core/texture/texture_decode.h"
+
+/**
+ * Decodes PICA textures with a compute shader. The tiles are uploaded as they are stored in 3DS
+ * memory and are decoded into an RGBA8 texture on the GPU, producing the same texels as
+ * Pica::Texture::DecodeTile.
+ */
+class ComputeTextureDecoder {
+public:
+    ComputeTextureDecoder();
+
+    /// Returns whether the host supports the extensions required by the decoder
+    static bool IsSupported();
+
+    /**
+     * Decodes the tiles covering a rectangle of a texture
+     * @param info TextureInfo describing the whole texture
+     * @param source Pointer to the texture in 3DS memory
+     * @param rect Rectangle to decode, in OpenGL coordinates of the texture. All of its edges must
+     *             be tile aligned
+     * @param dst_texture RGBA8 texture to store the decoded texels in
+     * @param dst_x, dst_y Position of the bottom left corner of the rectangle in dst_texture
+     * @returns false if the texture data did not fit into the upload buffer
+     */
+    bool Decode(const Pica::Texture::TextureInfo& info, const u8* source,
+                const MathUtil::Rectangle<u32>& rect, GLuint dst_texture, GLint dst_x,
+                GLint dst_y);
+
+private:
+    static constexpr GLsizeiptr SOURCE_BUFFER_SIZE = 8 * 1024 * 1024;
+
+    OGLProgram program;
+    OGLStreamBuffer source_buffer;
+    GLint source_buffer_alignment;
+};
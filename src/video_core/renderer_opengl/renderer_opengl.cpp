@@ -10,6 +10,8 @@
 #include "common/assert.h"
 #include "common/bit_field.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/frontend/emu_window.h"
@@ -94,11 +96,52 @@ static std::array<GLfloat, 3 * 2> MakeOrthographicMatrix(const float width, cons
     return matrix;
 }
 
+PresentFrame* FrameMailbox::GetRenderFrame() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& frame : frames) {
+        if (&frame != ready && &frame != presenting)
+            return &frame;
+    }
+    UNREACHABLE();
+    return nullptr;
+}
+
+bool FrameMailbox::ReleaseRenderFrame(PresentFrame* frame) {
+    bool replaced;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        replaced = ready != nullptr;
+        frame->submit_time = Core::PerfStats::Clock::now();
+        ready = frame;
+    }
+    frame_ready.notify_one();
+    return replaced;
+}
+
+PresentFrame* FrameMailbox::TryGetPresentFrame(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!frame_ready.wait_for(lock, timeout, [this] { return ready != nullptr; }))
+        return nullptr;
+    presenting = std::exchange(ready, nullptr);
+    return presenting;
+}
+
 RendererOpenGL::RendererOpenGL(EmuWindow& window) : RendererBase{window} {}
-RendererOpenGL::~RendererOpenGL() = default;
+
+RendererOpenGL::~RendererOpenGL() {
+    if (present_thread.joinable()) {
+        stop_presenting = true;
+        present_thread.join();
+    }
+    // The rasterizer is owned by the base class, release its objects while the context of the
+    // emulation thread still exists
+    rasterizer.reset();
+}
 
 /// Swap buffers (render frame)
 void RendererOpenGL::SwapBuffers() {
+    Rasterizer()->FlushTriangles();
+
     // Maintain the rasterizer's state as a priority
     OpenGLState prev_state = OpenGLState::GetCurState();
     state.Apply();
@@ -138,13 +181,19 @@ void RendererOpenGL::SwapBuffers() {
         }
     }
 
-    DrawScreens();
+    if (shared_context) {
+        RenderToMailbox();
+    } else {
+        DrawScreens();
+    }
 
     Core::System::GetInstance().perf_stats.EndSystemFrame();
 
     // Swap buffers
     render_window.PollEvents();
-    render_window.SwapBuffers();
+    if (!shared_context) {
+        render_window.SwapBuffers();
+    }
 
     Core::System::GetInstance().frame_limiter.DoFrameLimiting(CoreTiming::GetGlobalTimeUs());
     Core::System::GetInstance().perf_stats.BeginSystemFrame();
@@ -442,6 +491,90 @@ void RendererOpenGL::DrawScreens() {
 /// Updates the framerate
 void RendererOpenGL::UpdateFramerate() {}
 
+void RendererOpenGL::RenderToMailbox() {
+    const auto layout = render_window.GetFramebufferLayout();
+    PresentFrame* frame = mailbox.GetRenderFrame();
+
+    // Don't overwrite the frame before the presentation thread is done reading it
+    if (frame->present_fence.handle != nullptr) {
+        glWaitSync(frame->present_fence.handle, 0, GL_TIMEOUT_IGNORED);
+        frame->present_fence.Release();
+    }
+
+    if (frame->color.handle == 0 || frame->width != static_cast<GLsizei>(layout.width) ||
+        frame->height != static_cast<GLsizei>(layout.height)) {
+        frame->width = static_cast<GLsizei>(layout.width);
+        frame->height = static_cast<GLsizei>(layout.height);
+
+        frame->color.Release();
+        frame->color.Create();
+        state.texture_units[0].texture_2d = frame->color.handle;
+        state.Apply();
+        glActiveTexture(GL_TEXTURE0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, frame->width, frame->height, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, nullptr);
+        state.texture_units[0].texture_2d = 0;
+    }
+
+    state.draw.draw_framebuffer = mailbox_framebuffer.handle;
+    state.Apply();
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           frame->color.handle, 0);
+
+    DrawScreens();
+
+    state.draw.draw_framebuffer = 0;
+    state.Apply();
+
+    // The fence has to be flushed before the presentation thread waits on it
+    frame->render_fence.Release();
+    frame->render_fence.Create();
+    glFlush();
+
+    if (mailbox.ReleaseRenderFrame(frame)) {
+        Core::System::GetInstance().perf_stats.FrameDropped();
+    }
+}
+
+void RendererOpenGL::PresentLoop() {
+    Common::SetCurrentThreadName("PresentThread");
+    MicroProfileOnThreadCreate("PresentThread");
+
+    // Only raw OpenGL calls are made on this thread, as OpenGLState tracks the state of the
+    // emulation thread context
+    render_window.MakeCurrent();
+
+    GLuint read_framebuffer;
+    glGenFramebuffers(1, &read_framebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, read_framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+
+    while (!stop_presenting) {
+        PresentFrame* frame = mailbox.TryGetPresentFrame(std::chrono::milliseconds(100));
+        if (frame == nullptr)
+            continue;
+
+        glWaitSync(frame->render_fence.handle, 0, GL_TIMEOUT_IGNORED);
+
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                               frame->color.handle, 0);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glBlitFramebuffer(0, 0, frame->width, frame->height, 0, 0, frame->width, frame->height,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+        frame->present_fence.Release();
+        frame->present_fence.Create();
+        glFlush();
+
+        render_window.SwapBuffers();
+        Core::System::GetInstance().perf_stats.FramePresented(Core::PerfStats::Clock::now() -
+                                                              frame->submit_time);
+    }
+
+    glDeleteFramebuffers(1, &read_framebuffer);
+    render_window.DoneCurrent();
+}
+
 static const char* GetSource(GLenum source) {
 #define RET(s)                                                                                     \
     case GL_DEBUG_SOURCE_##s:                                                                      \
@@ -500,6 +633,13 @@ static void APIENTRY DebugHandler(GLenum source, GLenum type, GLuint id, GLenum
 Core::System::ResultStatus RendererOpenGL::Init() {
     render_window.MakeCurrent();
 
+    // When the frontend supports it, the window context is handed to the presentation thread and
+    // the emulation thread renders with a context sharing objects with it
+    shared_context = render_window.CreateSharedContext();
+    if (shared_context) {
+        shared_context->MakeCurrent();
+    }
+
     if (GLAD_GL_KHR_debug) {
         glEnable(GL_DEBUG_OUTPUT);
         glDebugMessageCallback(DebugHandler, nullptr);
@@ -529,6 +669,12 @@ Core::System::ResultStatus RendererOpenGL::Init() {
 
     RefreshRasterizerSetting();
 
+    if (shared_context) {
+        mailbox_framebuffer.Create();
+        present_thread = std::thread(&RendererOpenGL::PresentLoop, this);
+        LOG_INFO(Render_OpenGL, "Presenting frames on a separate thread");
+    }
+
     return Core::System::ResultStatus::Success;
 }
 
@@ -5,15 +5,23 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <glad/glad.h>
 #include "common/common_types.h"
 #include "common/math_util.h"
 #include "core/hw/gpu.h"
+#include "core/perf_stats.h"
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_state.h"
 
 class EmuWindow;
+class GraphicsContext;
 
 /// Structure used for storing information about the textures for each 3DS screen
 struct TextureInfo {
@@ -32,6 +40,51 @@ struct ScreenInfo {
     TextureInfo texture;
 };
 
+/// A frame drawn by the emulation thread, waiting to be presented by the presentation thread
+struct PresentFrame {
+    OGLTexture color;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    /// Signaled when the frame has been drawn
+    OGLSync render_fence;
+    /// Signaled when the presentation thread is done reading the frame
+    OGLSync present_fence;
+    /// Point when the frame was submitted for presentation
+    Core::PerfStats::Clock::time_point submit_time;
+};
+
+/**
+ * Triple buffered mailbox passing frames from the emulation thread to the presentation thread.
+ * The emulation thread never waits for a frame to be presented: a submitted frame that has not
+ * been picked up yet is replaced by the next one.
+ */
+class FrameMailbox {
+public:
+    /// Returns a frame which is neither waiting for presentation nor being presented
+    PresentFrame* GetRenderFrame();
+
+    /**
+     * Submits a frame for presentation
+     * @returns true if the frame replaced a previously submitted frame which was never presented
+     */
+    bool ReleaseRenderFrame(PresentFrame* frame);
+
+    /**
+     * Waits for a submitted frame and takes it for presentation. The previously presented frame
+     * is returned to the emulation thread.
+     * @returns nullptr if no frame was submitted before the timeout expired
+     */
+    PresentFrame* TryGetPresentFrame(std::chrono::milliseconds timeout);
+
+private:
+    std::array<PresentFrame, 3> frames;
+    PresentFrame* ready = nullptr;
+    PresentFrame* presenting = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable frame_ready;
+};
+
 class RendererOpenGL : public RendererBase {
 public:
     explicit RendererOpenGL(EmuWindow& window);
@@ -54,12 +107,21 @@ private:
     void DrawSingleScreenRotated(const ScreenInfo& screen_info, float x, float y, float w, float h);
     void UpdateFramerate();
 
+    /// Draws the screens into a frame of the mailbox and submits it for presentation
+    void RenderToMailbox();
+    /// Entry point of the presentation thread
+    void PresentLoop();
+
     // Loads framebuffer from emulated memory into the display information structure
     void LoadFBToScreenInfo(const GPU::Regs::FramebufferConfig& framebuffer,
                             ScreenInfo& screen_info, bool right_eye);
     // Fills active OpenGL texture with the given RGB color.
     void LoadColorToActiveGLTexture(u8 color_r, u8 color_g, u8 color_b, const TextureInfo& texture);
 
+    /// Context used by the emulation thread when the window context belongs to the presentation
+    /// thread. Declared first so that it outlives all other OpenGL objects of the renderer.
+    std::unique_ptr<GraphicsContext> shared_context;
+
     OpenGLState state;
 
     // OpenGL object IDs
@@ -77,4 +139,10 @@ private:
     // Shader attribute input indices
     GLuint attrib_position;
     GLuint attrib_tex_coord;
+
+    // Frame presentation on a separate thread, only used if the frontend provides a shared context
+    FrameMailbox mailbox;
+    OGLFramebuffer mailbox_framebuffer;
+    std::thread present_thread;
+    std::atomic_bool stop_presenting{false};
 };
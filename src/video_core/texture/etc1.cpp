@@ -70,19 +70,14 @@ union ETC1Tile {
         BitField<60, 4, u64> r1;
     } separate;
 
-    const Math::Vec3<u8> GetRGB(unsigned int x, unsigned int y) const {
-        int texel = 4 * x + y;
-
-        if (flip)
-            std::swap(x, y);
-
-        // Lookup base value
+    /// Returns the base color of the given half (0 or 1) of the subtile
+    Math::Vec3<int> GetBaseColor(unsigned half) const {
         Math::Vec3<int> ret;
         if (differential_mode) {
             ret.r() = static_cast<int>(differential.r);
             ret.g() = static_cast<int>(differential.g);
             ret.b() = static_cast<int>(differential.b);
-            if (x >= 2) {
+            if (half != 0) {
                 ret.r() += static_cast<int>(differential.dr);
                 ret.g() += static_cast<int>(differential.dg);
                 ret.b() += static_cast<int>(differential.db);
@@ -91,7 +86,7 @@ union ETC1Tile {
             ret.g() = Color::Convert5To8(ret.g());
             ret.b() = Color::Convert5To8(ret.b());
         } else {
-            if (x < 2) {
+            if (half == 0) {
                 ret.r() = Color::Convert4To8(static_cast<u8>(separate.r1));
                 ret.g() = Color::Convert4To8(static_cast<u8>(separate.g1));
                 ret.b() = Color::Convert4To8(static_cast<u8>(separate.b1));
@@ -101,21 +96,37 @@ union ETC1Tile {
                 ret.b() = Color::Convert4To8(static_cast<u8>(separate.b2));
             }
         }
+        return ret;
+    }
 
-        // Add modifier
-        unsigned table_index =
-            static_cast<int>((x < 2) ? table_index_1.Value() : table_index_2.Value());
+    unsigned GetTableIndex(unsigned half) const {
+        return static_cast<unsigned>((half == 0) ? table_index_1.Value() : table_index_2.Value());
+    }
 
+    /// Applies the modifier of the given texel to a base color
+    Math::Vec3<u8> ApplyModifier(const Math::Vec3<int>& base, unsigned table_index,
+                                 int texel) const {
         int modifier = etc1_modifier_table[table_index][GetTableSubIndex(texel)];
         if (GetNegationFlag(texel))
             modifier *= -1;
 
-        ret.r() = std::clamp(ret.r() + modifier, 0, 255);
-        ret.g() = std::clamp(ret.g() + modifier, 0, 255);
-        ret.b() = std::clamp(ret.b() + modifier, 0, 255);
+        Math::Vec3<int> ret;
+        ret.r() = std::clamp(base.r() + modifier, 0, 255);
+        ret.g() = std::clamp(base.g() + modifier, 0, 255);
+        ret.b() = std::clamp(base.b() + modifier, 0, 255);
 
         return ret.Cast<u8>();
     }
+
+    const Math::Vec3<u8> GetRGB(unsigned int x, unsigned int y) const {
+        int texel = 4 * x + y;
+
+        if (flip)
+            std::swap(x, y);
+
+        const unsigned half = (x < 2) ? 0 : 1;
+        return ApplyModifier(GetBaseColor(half), GetTableIndex(half), texel);
+    }
 };
 
 } // anonymous namespace
@@ -125,5 +136,22 @@ Math::Vec3<u8> SampleETC1Subtile(u64 value, unsigned int x, unsigned int y) {
     return tile.GetRGB(x, y);
 }
 
+void DecodeETC1Subtile(u64 value, std::array<Math::Vec3<u8>, 16>& out) {
+    const ETC1Tile tile{value};
+
+    // Both halves share their base color and modifier table, so only look them up once
+    const std::array<Math::Vec3<int>, 2> base_colors = {tile.GetBaseColor(0),
+                                                        tile.GetBaseColor(1)};
+    const std::array<unsigned, 2> table_indices = {tile.GetTableIndex(0), tile.GetTableIndex(1)};
+
+    for (unsigned int y = 0; y < 4; ++y) {
+        for (unsigned int x = 0; x < 4; ++x) {
+            const unsigned half = ((tile.flip ? y : x) < 2) ? 0 : 1;
+            out[x + 4 * y] =
+                tile.ApplyModifier(base_colors[half], table_indices[half], 4 * x + y);
+        }
+    }
+}
+
 } // namespace Texture
 } // namespace Pica
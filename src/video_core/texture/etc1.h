@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include "common/common_types.h"
 #include "common/vector_math.h"
 
@@ -12,5 +13,12 @@ namespace Texture {
 
 Math::Vec3<u8> SampleETC1Subtile(u64 value, unsigned int x, unsigned int y);
 
+/**
+ * Decodes all 16 texels of a 4x4 ETC1 subtile at once.
+ * @param value Encoded subtile data
+ * @param out Output texels, where texel (x, y) is stored at index x + 4 * y
+ */
+void DecodeETC1Subtile(u64 value, std::array<Math::Vec3<u8>, 16>& out);
+
 } // namespace Texture
 } // namespace Pica
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <cstring>
 #include "common/assert.h"
 #include "common/color.h"
 #include "common/logging/log.h"
@@ -72,41 +74,31 @@ Math::Vec4<u8> LookupTexture(const u8* source, unsigned int x, unsigned int y,
     return LookupTexelInTile(tile, fine_x, fine_y, info, disable_alpha);
 }
 
-Math::Vec4<u8> LookupTexelInTile(const u8* source, unsigned int x, unsigned int y,
-                                 const TextureInfo& info, bool disable_alpha) {
-    DEBUG_ASSERT(x < 8);
-    DEBUG_ASSERT(y < 8);
+namespace {
 
-    using VideoCore::MortonInterleave;
-
-    switch (info.format) {
-    case TextureFormat::RGBA8: {
-        auto res = Color::DecodeRGBA8(source + MortonInterleave(x, y) * 4);
+/**
+ * Decodes a single texel of a non-ETC1 texture format. The format is a template parameter so that
+ * the per-format code paths are resolved at compile time when decoding whole tiles.
+ */
+template <TextureFormat format>
+Math::Vec4<u8> DecodeTexel(const u8* source, u32 morton_offset, bool disable_alpha) {
+    if constexpr (format == TextureFormat::RGBA8) {
+        auto res = Color::DecodeRGBA8(source + morton_offset * 4);
         return {res.r(), res.g(), res.b(), static_cast<u8>(disable_alpha ? 255 : res.a())};
-    }
-
-    case TextureFormat::RGB8: {
-        auto res = Color::DecodeRGB8(source + MortonInterleave(x, y) * 3);
+    } else if constexpr (format == TextureFormat::RGB8) {
+        auto res = Color::DecodeRGB8(source + morton_offset * 3);
         return {res.r(), res.g(), res.b(), 255};
-    }
-
-    case TextureFormat::RGB5A1: {
-        auto res = Color::DecodeRGB5A1(source + MortonInterleave(x, y) * 2);
+    } else if constexpr (format == TextureFormat::RGB5A1) {
+        auto res = Color::DecodeRGB5A1(source + morton_offset * 2);
         return {res.r(), res.g(), res.b(), static_cast<u8>(disable_alpha ? 255 : res.a())};
-    }
-
-    case TextureFormat::RGB565: {
-        auto res = Color::DecodeRGB565(source + MortonInterleave(x, y) * 2);
+    } else if constexpr (format == TextureFormat::RGB565) {
+        auto res = Color::DecodeRGB565(source + morton_offset * 2);
         return {res.r(), res.g(), res.b(), 255};
-    }
-
-    case TextureFormat::RGBA4: {
-        auto res = Color::DecodeRGBA4(source + MortonInterleave(x, y) * 2);
+    } else if constexpr (format == TextureFormat::RGBA4) {
+        auto res = Color::DecodeRGBA4(source + morton_offset * 2);
         return {res.r(), res.g(), res.b(), static_cast<u8>(disable_alpha ? 255 : res.a())};
-    }
-
-    case TextureFormat::IA8: {
-        const u8* source_ptr = source + MortonInterleave(x, y) * 2;
+    } else if constexpr (format == TextureFormat::IA8) {
+        const u8* source_ptr = source + morton_offset * 2;
 
         if (disable_alpha) {
             // Show intensity as red, alpha as green
@@ -114,30 +106,22 @@ Math::Vec4<u8> LookupTexelInTile(const u8* source, unsigned int x, unsigned int
         } else {
             return {source_ptr[1], source_ptr[1], source_ptr[1], source_ptr[0]};
         }
-    }
-
-    case TextureFormat::RG8: {
-        auto res = Color::DecodeRG8(source + MortonInterleave(x, y) * 2);
+    } else if constexpr (format == TextureFormat::RG8) {
+        auto res = Color::DecodeRG8(source + morton_offset * 2);
         return {res.r(), res.g(), 0, 255};
-    }
-
-    case TextureFormat::I8: {
-        const u8* source_ptr = source + MortonInterleave(x, y);
+    } else if constexpr (format == TextureFormat::I8) {
+        const u8* source_ptr = source + morton_offset;
         return {*source_ptr, *source_ptr, *source_ptr, 255};
-    }
-
-    case TextureFormat::A8: {
-        const u8* source_ptr = source + MortonInterleave(x, y);
+    } else if constexpr (format == TextureFormat::A8) {
+        const u8* source_ptr = source + morton_offset;
 
         if (disable_alpha) {
             return {*source_ptr, *source_ptr, *source_ptr, 255};
         } else {
             return {0, 0, 0, *source_ptr};
         }
-    }
-
-    case TextureFormat::IA4: {
-        const u8* source_ptr = source + MortonInterleave(x, y);
+    } else if constexpr (format == TextureFormat::IA4) {
+        const u8* source_ptr = source + morton_offset;
 
         u8 i = Color::Convert4To8(((*source_ptr) & 0xF0) >> 4);
         u8 a = Color::Convert4To8((*source_ptr) & 0xF);
@@ -148,20 +132,14 @@ Math::Vec4<u8> LookupTexelInTile(const u8* source, unsigned int x, unsigned int
         } else {
             return {i, i, i, a};
         }
-    }
-
-    case TextureFormat::I4: {
-        u32 morton_offset = MortonInterleave(x, y);
+    } else if constexpr (format == TextureFormat::I4) {
         const u8* source_ptr = source + morton_offset / 2;
 
         u8 i = (morton_offset % 2) ? ((*source_ptr & 0xF0) >> 4) : (*source_ptr & 0xF);
         i = Color::Convert4To8(i);
 
         return {i, i, i, 255};
-    }
-
-    case TextureFormat::A4: {
-        u32 morton_offset = MortonInterleave(x, y);
+    } else if constexpr (format == TextureFormat::A4) {
         const u8* source_ptr = source + morton_offset / 2;
 
         u8 a = (morton_offset % 2) ? ((*source_ptr & 0xF0) >> 4) : (*source_ptr & 0xF);
@@ -172,7 +150,117 @@ Math::Vec4<u8> LookupTexelInTile(const u8* source, unsigned int x, unsigned int
         } else {
             return {0, 0, 0, a};
         }
+    } else {
+        static_assert(format != format, "Unsupported texture format");
     }
+}
+
+template <TextureFormat format>
+void DecodeTileImpl(const u8* source, u8* dst, ptrdiff_t dst_stride, bool disable_alpha) {
+    using VideoCore::MortonInterleave;
+
+    for (unsigned int y = 0; y < 8; ++y) {
+        u8* dst_row = dst + y * dst_stride;
+        for (unsigned int x = 0; x < 8; ++x) {
+            auto texel = DecodeTexel<format>(source, MortonInterleave(x, y), disable_alpha);
+            std::memcpy(dst_row + x * 4, texel.AsArray(), 4);
+        }
+    }
+}
+
+void DecodeETC1Tile(const u8* source, bool has_alpha, u8* dst, ptrdiff_t dst_stride,
+                    bool disable_alpha) {
+    const std::size_t subtile_size = has_alpha ? 16 : 8;
+
+    // ETC1 further subdivides each 8x8 tile into four 4x4 subtiles
+    std::array<Math::Vec3<u8>, 16> colors;
+    for (unsigned int subtile_index = 0; subtile_index < ETC1_SUBTILES; ++subtile_index) {
+        const unsigned int subtile_x = (subtile_index % 2) * 4;
+        const unsigned int subtile_y = (subtile_index / 2) * 4;
+        const u8* subtile_ptr = source + subtile_index * subtile_size;
+
+        u64_le packed_alpha = 0;
+        if (has_alpha) {
+            memcpy(&packed_alpha, subtile_ptr, sizeof(u64));
+            subtile_ptr += sizeof(u64);
+        }
+
+        u64_le subtile_data;
+        memcpy(&subtile_data, subtile_ptr, sizeof(u64));
+        DecodeETC1Subtile(subtile_data, colors);
+
+        for (unsigned int y = 0; y < 4; ++y) {
+            u8* dst_row = dst + (subtile_y + y) * dst_stride + subtile_x * 4;
+            for (unsigned int x = 0; x < 4; ++x) {
+                u8 alpha = 255;
+                if (has_alpha && !disable_alpha) {
+                    alpha = Color::Convert4To8((packed_alpha >> (4 * (x * 4 + y))) & 0xF);
+                }
+
+                const Math::Vec3<u8>& color = colors[x + 4 * y];
+                dst_row[x * 4 + 0] = color.r();
+                dst_row[x * 4 + 1] = color.g();
+                dst_row[x * 4 + 2] = color.b();
+                dst_row[x * 4 + 3] = alpha;
+            }
+        }
+    }
+}
+
+constexpr std::array<Math::Vec4<u8> (*)(const u8*, u32, bool), 12> decode_texel_fns = {
+    DecodeTexel<TextureFormat::RGBA8>,  // 0
+    DecodeTexel<TextureFormat::RGB8>,   // 1
+    DecodeTexel<TextureFormat::RGB5A1>, // 2
+    DecodeTexel<TextureFormat::RGB565>, // 3
+    DecodeTexel<TextureFormat::RGBA4>,  // 4
+    DecodeTexel<TextureFormat::IA8>,    // 5
+    DecodeTexel<TextureFormat::RG8>,    // 6
+    DecodeTexel<TextureFormat::I8>,     // 7
+    DecodeTexel<TextureFormat::A8>,     // 8
+    DecodeTexel<TextureFormat::IA4>,    // 9
+    DecodeTexel<TextureFormat::I4>,     // 10
+    DecodeTexel<TextureFormat::A4>,     // 11
+};
+
+constexpr std::array<void (*)(const u8*, u8*, ptrdiff_t, bool), 12> decode_tile_fns = {
+    DecodeTileImpl<TextureFormat::RGBA8>,  // 0
+    DecodeTileImpl<TextureFormat::RGB8>,   // 1
+    DecodeTileImpl<TextureFormat::RGB5A1>, // 2
+    DecodeTileImpl<TextureFormat::RGB565>, // 3
+    DecodeTileImpl<TextureFormat::RGBA4>,  // 4
+    DecodeTileImpl<TextureFormat::IA8>,    // 5
+    DecodeTileImpl<TextureFormat::RG8>,    // 6
+    DecodeTileImpl<TextureFormat::I8>,     // 7
+    DecodeTileImpl<TextureFormat::A8>,     // 8
+    DecodeTileImpl<TextureFormat::IA4>,    // 9
+    DecodeTileImpl<TextureFormat::I4>,     // 10
+    DecodeTileImpl<TextureFormat::A4>,     // 11
+};
+
+} // anonymous namespace
+
+Math::Vec4<u8> LookupTexelInTile(const u8* source, unsigned int x, unsigned int y,
+                                 const TextureInfo& info, bool disable_alpha) {
+    DEBUG_ASSERT(x < 8);
+    DEBUG_ASSERT(y < 8);
+
+    using VideoCore::MortonInterleave;
+
+    switch (info.format) {
+    case TextureFormat::RGBA8:
+    case TextureFormat::RGB8:
+    case TextureFormat::RGB5A1:
+    case TextureFormat::RGB565:
+    case TextureFormat::RGBA4:
+    case TextureFormat::IA8:
+    case TextureFormat::RG8:
+    case TextureFormat::I8:
+    case TextureFormat::A8:
+    case TextureFormat::IA4:
+    case TextureFormat::I4:
+    case TextureFormat::A4:
+        return decode_texel_fns[static_cast<std::size_t>(info.format)](
+            source, MortonInterleave(x, y), disable_alpha);
 
     case TextureFormat::ETC1:
     case TextureFormat::ETC1A4: {
@@ -212,6 +300,56 @@ Math::Vec4<u8> LookupTexelInTile(const u8* source, unsigned int x, unsigned int
     }
 }
 
+void DecodeTile(const u8* source, const TextureInfo& info, u8* dst, ptrdiff_t dst_stride,
+                bool disable_alpha) {
+    switch (info.format) {
+    case TextureFormat::RGBA8:
+    case TextureFormat::RGB8:
+    case TextureFormat::RGB5A1:
+    case TextureFormat::RGB565:
+    case TextureFormat::RGBA4:
+    case TextureFormat::IA8:
+    case TextureFormat::RG8:
+    case TextureFormat::I8:
+    case TextureFormat::A8:
+    case TextureFormat::IA4:
+    case TextureFormat::I4:
+    case TextureFormat::A4:
+        decode_tile_fns[static_cast<std::size_t>(info.format)](source, dst, dst_stride,
+                                                                disable_alpha);
+        break;
+
+    case TextureFormat::ETC1:
+    case TextureFormat::ETC1A4:
+        DecodeETC1Tile(source, info.format == TextureFormat::ETC1A4, dst, dst_stride,
+                       disable_alpha);
+        break;
+
+    default:
+        LOG_ERROR(HW_GPU, "Unknown texture format: {:x}", (u32)info.format);
+        DEBUG_ASSERT(false);
+        break;
+    }
+}
+
+void DecodeTexture(const TextureInfo& info, const u8* source, u8* dst, bool disable_alpha) {
+    DEBUG_ASSERT(info.width % 8 == 0);
+    DEBUG_ASSERT(info.height % 8 == 0);
+
+    const std::size_t tile_size = CalculateTileSize(info.format);
+    const ptrdiff_t dst_stride = info.width * 4;
+
+    for (unsigned int coarse_y = 0; coarse_y < info.height / 8; ++coarse_y) {
+        const u8* tile = source + coarse_y * info.stride;
+        u8* dst_tile = dst + coarse_y * 8 * dst_stride;
+        for (unsigned int coarse_x = 0; coarse_x < info.width / 8; ++coarse_x) {
+            DecodeTile(tile, info, dst_tile, dst_stride, disable_alpha);
+            tile += tile_size;
+            dst_tile += 8 * 4;
+        }
+    }
+}
+
 TextureInfo TextureInfo::FromPicaRegister(const TexturingRegs::TextureConfig& config,
                                           const TexturingRegs::TextureFormat& format) {
     TextureInfo info;
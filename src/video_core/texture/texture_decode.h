@@ -56,5 +56,31 @@ Math::Vec4<u8> LookupTexture(const u8* source, unsigned int x, unsigned int y,
 Math::Vec4<u8> LookupTexelInTile(const u8* source, unsigned int x, unsigned int y,
                                  const TextureInfo& info, bool disable_alpha);
 
+/**
+ * Decodes a whole 8x8 texture tile into RGBA8 texels.
+ *
+ * @param source Pointer to the beginning of the tile.
+ * @param info TextureInfo describing the texture format.
+ * @param dst Pointer to the decoded texel at in-tile coordinate (0, 0). Each texel is written as
+ *            four bytes in R, G, B, A order.
+ * @param dst_stride Distance in bytes between two consecutive tile rows in dst. May be negative
+ *                   to store the tile bottom-up.
+ * @param disable_alpha Same as for LookupTexelInTile.
+ */
+void DecodeTile(const u8* source, const TextureInfo& info, u8* dst, ptrdiff_t dst_stride,
+                bool disable_alpha = false);
+
+/**
+ * Decodes a whole texture into linear RGBA8 texels. This produces the same result as calling
+ * LookupTexture for every texel, but works on entire tiles at a time.
+ *
+ * @param info TextureInfo describing the texture setup. Width and height must be multiples of 8.
+ * @param source Source pointer to read data from
+ * @param dst Destination buffer of info.width * info.height * 4 bytes. Rows are stored in
+ *            increasing y order, with the same coordinates as used by LookupTexture.
+ * @param disable_alpha Same as for LookupTexture.
+ */
+void DecodeTexture(const TextureInfo& info, const u8* source, u8* dst, bool disable_alpha = false);
+
 } // namespace Texture
 } // namespace Pica